@@ -2,10 +2,12 @@
 #include "liblelantus/sigmaextended_verifier.h"
 #include "liblelantus/threadpool.h"
 #include "liblelantus/range_verifier.h"
+#include "liblelantus/schnorr_verifier.h"
 #include "sigma/sigmaplus_verifier.h"
 #include "sigma.h"
 #include "lelantus.h"
 #include "ui_interface.h"
+#include "util.h"
 
 std::unique_ptr<BatchProofContainer> BatchProofContainer::instance;
 
@@ -22,32 +24,226 @@ void BatchProofContainer::init() {
     tempSigmaProofs.clear();
     tempLelantusSigmaProofs.clear();
     tempRangeProofs.clear();
+    tempMintProofs.clear();
+    blockChecks.reset(new WorkStealingThreadPool::TaskGroup());
 }
 
-void BatchProofContainer::finalize() {
+void BatchProofContainer::finalize(int nHeight) {
     if (fCollectProofs) {
+        bool fHasProofs = !tempSigmaProofs.empty() || !tempLelantusSigmaProofs.empty() || !tempRangeProofs.empty()
+                || !tempMintProofs.empty();
+
         for (const auto& itr : tempSigmaProofs) {
-            sigmaProofs[itr.first].insert(sigmaProofs[itr.first].begin(), itr.second.begin(), itr.second.end());
+            auto& vProofs = currentWindow.sigmaProofs[itr.first];
+            vProofs.insert(vProofs.begin(), itr.second.begin(), itr.second.end());
         }
 
         for (const auto& itr : tempLelantusSigmaProofs) {
-            lelantusSigmaProofs[itr.first].insert(lelantusSigmaProofs[itr.first].begin(), itr.second.begin(), itr.second.end());
+            auto& vProofs = currentWindow.lelantusSigmaProofs[itr.first];
+            vProofs.insert(vProofs.begin(), itr.second.begin(), itr.second.end());
         }
 
         for (const auto& itr : tempRangeProofs) {
-            rangeProofs[itr.first].insert(rangeProofs[itr.first].begin(), itr.second.begin(), itr.second.end());
+            auto& vProofs = currentWindow.rangeProofs[itr.first];
+            vProofs.insert(vProofs.begin(), itr.second.begin(), itr.second.end());
+        }
+
+        for (auto& mintProof : tempMintProofs) {
+            mintProof.nHeight = nHeight;
+            currentWindow.mintProofs.push_back(mintProof);
         }
+
+        if (fHasProofs) {
+            if (currentWindow.nFirstHeight < 0 || nHeight < currentWindow.nFirstHeight)
+                currentWindow.nFirstHeight = nHeight;
+            currentWindow.nLastHeight = std::max(currentWindow.nLastHeight, nHeight);
+        }
+    } else if (failedRange.first >= 0 && nHeight == failedRange.second) {
+        // the failed range was reconnected verifying proofs one by one
+        failedRange = std::make_pair(-1, -1);
     }
     fCollectProofs = false;
+    updateFirstUnverifiedHeight();
+}
+
+void BatchProofContainer::finalize() {
+    // only wait for the round which is already running, the rest is verified again on the next start
+    if (!waitForBackgroundRound())
+        LogPrintf("Batch verification of blocks %d-%d failed on shutdown, they will be verified again on the next start\n",
+                  failedRange.first, failedRange.second);
+    if (currentWindow.nFirstHeight >= 0)
+        LogPrintf("Proofs of blocks %d-%d are not verified yet, they will be verified again on the next start\n",
+                  currentWindow.nFirstHeight, currentWindow.nLastHeight);
+    fCollectProofs = false;
+    updateFirstUnverifiedHeight();
 }
 
-void BatchProofContainer::verify() {
+bool BatchProofContainer::verify() {
+    bool fSuccess = true;
     if (!fCollectProofs) {
-        batch_sigma();
-        batch_lelantus();
-        batch_rangeProofs();
+        // we are synced, verify everything collected so far
+        fSuccess = waitForBackgroundRound();
+        if (fSuccess && proofsCount() > 0) {
+            ProofWindow window;
+            std::swap(window, currentWindow);
+            fillAnonymitySets(window);
+            fSuccess = verifyWindow(window);
+            onRoundFinished(window, fSuccess);
+        }
+    } else {
+        int64_t nWindowSize = GetArg("-batchingwindow", DEFAULT_BATCHING_WINDOW);
+        if (nWindowSize > 0 && proofsCount() >= (size_t)nWindowSize) {
+            // keep at most two windows in memory, the one being collected and the one being verified
+            fSuccess = waitForBackgroundRound();
+            if (fSuccess) {
+                backgroundWindow.reset(new ProofWindow());
+                std::swap(*backgroundWindow, currentWindow);
+                // anonymity sets have to be read here, state can't be accessed from the background thread
+                fillAnonymitySets(*backgroundWindow);
+
+                ProofWindow* window = backgroundWindow.get();
+                backgroundResult = backgroundThread.PostTask([this, window]() {
+                    return verifyWindow(*window);
+                });
+            }
+        }
     }
+
+    if (!fSuccess) {
+        // everything collected after the failed range will be reconnected anyway
+        currentWindow = ProofWindow();
+    }
+
     fCollectProofs = false;
+    updateFirstUnverifiedHeight();
+    return fSuccess;
+}
+
+bool BatchProofContainer::isFailedRange(int nHeight) const {
+    return failedRange.first >= 0 && nHeight >= failedRange.first && nHeight <= failedRange.second;
+}
+
+size_t BatchProofContainer::proofsCount() const {
+    size_t count = 0;
+    for (const auto& itr : currentWindow.sigmaProofs)
+        count += itr.second.size();
+    for (const auto& itr : currentWindow.lelantusSigmaProofs)
+        count += itr.second.size();
+    for (const auto& itr : currentWindow.rangeProofs)
+        count += itr.second.size();
+    count += currentWindow.mintProofs.size();
+    return count;
+}
+
+void BatchProofContainer::fillAnonymitySets(ProofWindow& window) const {
+    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+    for (const auto& itr : window.sigmaProofs) {
+        if (itr.second.empty())
+            continue;
+        sigmaState->GetAnonymitySet(
+                itr.first.first,
+                itr.first.second.first,
+                itr.first.second.second,
+                window.sigmaSets[itr.first]);
+    }
+
+    lelantus::CLelantusState* lelantusState = lelantus::CLelantusState::GetState();
+    for (const auto& itr : window.lelantusSigmaProofs) {
+        if (itr.second.empty())
+            continue;
+        std::vector<GroupElement>& anonymity_set = window.lelantusSets[itr.first];
+        if (!itr.first.second) {
+            lelantusState->GetAnonymitySet(
+                    itr.first.first.first,
+                    itr.first.first.second,
+                    anonymity_set);
+        } else {
+            // sigma coins come from the cache with denomination already added
+            int coinGroupId = itr.first.first.first % (CENT / 1000);
+            int64_t intDenom = (itr.first.first.first - coinGroupId);
+            intDenom *= 1000;
+            sigma::CoinDenomination denomination;
+            sigma::IntegerToDenomination(intDenom, denomination);
+
+            lelantusState->GetSigmaToLelantusAnonymitySet(
+                    denomination,
+                    coinGroupId,
+                    true,
+                    anonymity_set);
+        }
+    }
+}
+
+bool BatchProofContainer::verifyWindow(ProofWindow& window) {
+    bool fSuccess = batch_sigma(window) && batch_lelantus(window) && batch_rangeProofs(window) && batch_mints(window);
+
+    // anonymity sets are the largest part of the window, release them as soon as possible
+    window.sigmaSets.clear();
+    window.lelantusSets.clear();
+    return fSuccess;
+}
+
+bool BatchProofContainer::waitForBackgroundRound() {
+    if (!backgroundWindow)
+        return true;
+
+    bool fSuccess = backgroundResult.get();
+    onRoundFinished(*backgroundWindow, fSuccess);
+    backgroundWindow.reset();
+    return fSuccess;
+}
+
+void BatchProofContainer::reclaimBackgroundWindow() {
+    if (!backgroundWindow)
+        return;
+
+    if (backgroundResult.get()) {
+        onRoundFinished(*backgroundWindow, true);
+    } else {
+        // the failure may come from proofs of the blocks being disconnected, so the window isn't reported as failed,
+        // it is merged back into the current one and verified again after they are removed
+        ProofWindow& window = *backgroundWindow;
+        for (auto& itr : window.sigmaProofs) {
+            auto& vProofs = currentWindow.sigmaProofs[itr.first];
+            vProofs.insert(vProofs.end(), itr.second.begin(), itr.second.end());
+        }
+        for (auto& itr : window.lelantusSigmaProofs) {
+            auto& vProofs = currentWindow.lelantusSigmaProofs[itr.first];
+            vProofs.insert(vProofs.end(), itr.second.begin(), itr.second.end());
+        }
+        for (auto& itr : window.rangeProofs) {
+            auto& vProofs = currentWindow.rangeProofs[itr.first];
+            vProofs.insert(vProofs.end(), itr.second.begin(), itr.second.end());
+        }
+        currentWindow.mintProofs.insert(currentWindow.mintProofs.end(), window.mintProofs.begin(), window.mintProofs.end());
+
+        if (window.nFirstHeight >= 0) {
+            if (currentWindow.nFirstHeight < 0 || window.nFirstHeight < currentWindow.nFirstHeight)
+                currentWindow.nFirstHeight = window.nFirstHeight;
+            currentWindow.nLastHeight = std::max(currentWindow.nLastHeight, window.nLastHeight);
+        }
+    }
+    backgroundWindow.reset();
+}
+
+void BatchProofContainer::onRoundFinished(const ProofWindow& window, bool fSuccess) {
+    if (fSuccess) {
+        nLastVerifiedHeight = std::max(nLastVerifiedHeight, window.nLastHeight);
+        LogPrintf("Batch verification of blocks %d-%d finished successfully.\n", window.nFirstHeight, window.nLastHeight);
+    } else {
+        failedRange = std::make_pair(window.nFirstHeight, window.nLastHeight);
+        LogPrintf("Batch verification of blocks %d-%d failed, these blocks will be verified without batching.\n",
+                  window.nFirstHeight, window.nLastHeight);
+    }
+}
+
+void BatchProofContainer::updateFirstUnverifiedHeight() {
+    int nHeight = failedRange.first;
+    for (int nWindowHeight : {backgroundWindow ? backgroundWindow->nFirstHeight : -1, currentWindow.nFirstHeight}) {
+        if (nWindowHeight >= 0 && (nHeight < 0 || nWindowHeight < nHeight))
+            nHeight = nWindowHeight;
+    }
+    nFirstUnverifiedHeight = nHeight;
 }
 
 void BatchProofContainer::add(sigma::CoinSpend* spend,
@@ -55,12 +251,12 @@ void BatchProofContainer::add(sigma::CoinSpend* spend,
                               int group_id,
                               size_t setSize,
                               bool fStartSigmaBlacklist) {
-    std::pair<sigma::CoinDenomination,  std::pair<int, bool>> denominationAndId = std::make_pair(
+    SigmaKey denominationAndId = std::make_pair(
             spend->getDenomination(), std::make_pair(group_id, fStartSigmaBlacklist));
     tempSigmaProofs[denominationAndId].push_back(SigmaProofData(spend->getProof(), spend->getCoinSerialNumber(), fPadding, setSize));
 }
 
-void BatchProofContainer::add(lelantus::JoinSplit* joinSplit,
+void BatchProofContainer::add(const lelantus::JoinSplit* joinSplit,
                               const std::map<uint32_t, size_t>& setSizes,
                               const Scalar& challenge,
                               bool fStartLelantusBlacklist) {
@@ -76,19 +272,48 @@ void BatchProofContainer::add(lelantus::JoinSplit* joinSplit,
         sigma::CoinDenomination denomination;
         bool isSigma = sigma::IntegerToDenomination(intDenom, denomination) && joinSplit->isSigmaToLelantus();
         // pair(pair(set id, fAfterFixes), isSigmaToLelantus)
-        std::pair<std::pair<uint32_t, bool>, bool> idAndFlag = std::make_pair(std::make_pair(groupIds[i], fStartLelantusBlacklist), isSigma);
+        LelantusKey idAndFlag = std::make_pair(std::make_pair(groupIds[i], fStartLelantusBlacklist), isSigma);
         tempLelantusSigmaProofs[idAndFlag].push_back(LelantusSigmaProofData(sigma_proofs[i], serials[i], challenge, setSizes.at(groupIds[i])));
     }
 }
 
 
-void BatchProofContainer::add(lelantus::JoinSplit* joinSplit, const std::vector<lelantus::PublicCoin>& Cout) {
+void BatchProofContainer::add(const lelantus::JoinSplit* joinSplit, const std::vector<lelantus::PublicCoin>& Cout) {
     tempRangeProofs[joinSplit->getVersion()].push_back(std::make_pair(joinSplit->getLelantusProof().bulletproofs, Cout));
 }
 
+void BatchProofContainer::add(const GroupElement& comm, const Scalar& challenge, const lelantus::SchnorrProof& schnorrProof) {
+    tempMintProofs.push_back(MintSchnorrProofData(comm, challenge, schnorrProof));
+}
+
+bool BatchProofContainer::verifyMints() {
+    if (fCollectProofs)
+        return true;
+
+    bool fSuccess = verify_mints(tempMintProofs);
+    tempMintProofs.clear();
+    return fSuccess;
+}
+
+void BatchProofContainer::verifyInParallel(std::function<bool()> check) {
+    assert(blockChecks);
+    blockChecks->Run(std::move(check));
+}
+
+bool BatchProofContainer::waitForParallelChecks() {
+    if (!blockChecks)
+        return true;
+
+    DoNotDisturb dnd;
+    bool fSuccess = blockChecks->Wait();
+    blockChecks.reset();
+    return fSuccess;
+}
+
 void BatchProofContainer::removeSigma(const sigma::spend_info_container& spendSerials) {
+    reclaimBackgroundWindow();
     for (auto& spendSerial : spendSerials) {
-        for (auto& itr :sigmaProofs) {
+        for (auto& itr : currentWindow.sigmaProofs) {
             if (itr.first.first == spendSerial.second.denomination && itr.first.second.first == spendSerial.second.coinGroupId) {
                 auto& vProofs = itr.second;
                 for (auto dataItr = vProofs.begin(); dataItr != vProofs.end(); dataItr++) {
@@ -102,6 +327,7 @@ void BatchProofContainer::removeSigma(const sigma::spend_info_container& spendSe
     }
 }
 void BatchProofContainer::removeLelantus(std::unordered_map<Scalar, int> spentSerials) {
+    reclaimBackgroundWindow();
     for (auto& spendSerial : spentSerials) {
 
         int id = spendSerial.second;
@@ -114,23 +340,25 @@ void BatchProofContainer::removeLelantus(std::unordered_map<Scalar, int> spentSe
             isSigmaToLela = true;
 
         // afterFixes bool with the pair of set id is considered separate set identifiers, so try to find in one set, if not found try also in another
-        std::pair<std::pair<uint32_t, bool>, bool> key1 = std::make_pair(std::make_pair(id, false), isSigmaToLela);
-        std::pair<std::pair<uint32_t, bool>, bool> key2 = std::make_pair(std::make_pair(id, true), isSigmaToLela);
+        LelantusKey key1 = std::make_pair(std::make_pair(id, false), isSigmaToLela);
+        LelantusKey key2 = std::make_pair(std::make_pair(id, true), isSigmaToLela);
         std::vector<LelantusSigmaProofData>* vProofs;
-        if (lelantusSigmaProofs.count(key1) > 0) {
-            vProofs = &lelantusSigmaProofs[key1];
+        if (currentWindow.lelantusSigmaProofs.count(key1) > 0) {
+            vProofs = &currentWindow.lelantusSigmaProofs[key1];
             erase(vProofs, spendSerial.first);
         }
 
-        if (lelantusSigmaProofs.count(key2) > 0) {
-            vProofs = &lelantusSigmaProofs[key2];
+        if (currentWindow.lelantusSigmaProofs.count(key2) > 0) {
+            vProofs = &currentWindow.lelantusSigmaProofs[key2];
             erase(vProofs, spendSerial.first);
         }
     }
 }
 
 void BatchProofContainer::remove(const std::vector<lelantus::RangeProof>& rangeProofsToRemove) {
+    reclaimBackgroundWindow();
     for (auto& itrRemove : rangeProofsToRemove) {
+        auto& rangeProofs = currentWindow.rangeProofs;
         for (auto itrVersions = rangeProofs.begin(); itrVersions != rangeProofs.end(); ++itrVersions) {
             bool found = false;
             for (auto itr = itrVersions->second.begin(); itr != itrVersions->second.end(); ++itr) {
@@ -150,6 +378,24 @@ void BatchProofContainer::remove(const std::vector<lelantus::RangeProof>& rangeP
     }
 }
 
+void BatchProofContainer::removeBlock(int nHeight) {
+    reclaimBackgroundWindow();
+
+    auto& mintProofs = currentWindow.mintProofs;
+    mintProofs.erase(std::remove_if(mintProofs.begin(),
+                                    mintProofs.end(),
+                                    [nHeight](const MintSchnorrProofData& proof){return proof.nHeight == nHeight;}),
+                     mintProofs.end());
+
+    // blocks are disconnected from the tip, so the window has no proofs above nHeight left
+    if (currentWindow.nFirstHeight >= nHeight)
+        currentWindow = ProofWindow();
+    else if (currentWindow.nLastHeight >= nHeight)
+        currentWindow.nLastHeight = nHeight - 1;
+    nLastVerifiedHeight = std::min(nLastVerifiedHeight, nHeight - 1);
+    updateFirstUnverifiedHeight();
+}
+
 void BatchProofContainer::erase(std::vector<LelantusSigmaProofData>* vProofs, const Scalar& serial) {
     vProofs->erase(std::remove_if(vProofs->begin(),
                                   vProofs->end(),
@@ -158,191 +404,135 @@ void BatchProofContainer::erase(std::vector<LelantusSigmaProofData>* vProofs, co
 
 }
 
-void BatchProofContainer::batch_sigma() {
+bool BatchProofContainer::batch_sigma(const ProofWindow& window) {
+    const auto& sigmaProofs = window.sigmaProofs;
     if (!sigmaProofs.empty()){
         LogPrintf("Sigma batch verification started.\n");
         uiInterface.UpdateProgressBarLabel("Batch verifying Sigma...");
     }
     else
-        return;
+        return true;
 
     DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)sigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
-
     auto params = sigma::Params::get_default();
     sigma::SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
 
-    auto itr = sigmaProofs.begin();
-    for (std::size_t j = 0; j < sigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < sigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                sigmaState->GetAnonymitySet(
-                        itr->first.first,
-                        itr->first.second.first,
-                        itr->first.second.second,
-                        anonymity_set);
-
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<bool> fPadding;
-                fPadding.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
-                proofs.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.coinSerialNumber);
-                    fPadding.emplace_back(proofData.fPadding);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.sigmaProof);
-                }
-
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batch_verify(anonymity_set, serials, fPadding, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-
-                ++itr;
+    // all groups are posted at once, so a large anonymity set doesn't hold back the others
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (const auto& itr : sigmaProofs) {
+        if (itr.second.empty())
+            continue;
+
+        const std::vector<GroupElement>& anonymity_set = window.sigmaSets.at(itr.first);
+        const std::vector<SigmaProofData>& proofData = itr.second;
+        tasks.Run([&sigmaVerifier, &anonymity_set, &proofData]() {
+            size_t m = proofData.size();
+            std::vector<Scalar> serials;
+            serials.reserve(m);
+            std::vector<bool> fPadding;
+            fPadding.reserve(m);
+            std::vector<size_t> setSizes;
+            setSizes.reserve(m);
+            std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
+            proofs.reserve(m);
+
+            for (auto& data : proofData) {
+                serials.emplace_back(data.coinSerialNumber);
+                fPadding.emplace_back(data.fPadding);
+                setSizes.emplace_back(data.anonymitySetSize);
+                proofs.emplace_back(data.sigmaProof);
             }
-        }
 
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
-        if (isFail) {
-            LogPrintf("Sigma batch verification failed.");
-            throw std::invalid_argument(
-                    "Sigma batch verification failed, please run Firo with -reindex -batching=0");
-        }
-        parallelTasks.clear();
+            return sigmaVerifier.batch_verify(anonymity_set, serials, fPadding, setSizes, proofs);
+        });
+    }
+
+    if (!tasks.Wait()) {
+        LogPrintf("Sigma batch verification failed.\n");
+        return false;
     }
-    if (!sigmaProofs.empty())
-        LogPrintf("Sigma batch verification finished successfully.\n");
-    sigmaProofs.clear();
+
+    LogPrintf("Sigma batch verification finished successfully.\n");
+    return true;
 }
 
-void BatchProofContainer::batch_lelantus() {
+bool BatchProofContainer::batch_lelantus(const ProofWindow& window) {
+    const auto& lelantusSigmaProofs = window.lelantusSigmaProofs;
     if (!lelantusSigmaProofs.empty()){
         LogPrintf("Lelantus batch verification started.\n");
         uiInterface.UpdateProgressBarLabel("Batch verifying Lelantus...");
     }
     else
-        return;
+        return true;
 
     auto params = lelantus::Params::get_default();
 
     DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)lelantusSigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
-    auto itr = lelantusSigmaProofs.begin();
-
     lelantus::SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
-                                                  params->get_sigma_m());
-    for (std::size_t j = 0; j < lelantusSigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < lelantusSigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                if (!itr->first.second) {
-                    lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
-                    std::vector<lelantus::PublicCoin> coins;
-                    state->GetAnonymitySet(
-                            itr->first.first.first,
-                            itr->first.first.second,
-                            coins);
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin.getValue());
-                } else {
-                    int coinGroupId = itr->first.first.first % (CENT / 1000);
-                    int64_t intDenom = (itr->first.first.first - coinGroupId);
-                    intDenom *= 1000;
-                    sigma::CoinDenomination denomination;
-                    sigma::IntegerToDenomination(intDenom, denomination);
-
-                    std::vector<GroupElement> coins;
-                    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                    sigmaState->GetAnonymitySet(
-                            denomination,
-                            coinGroupId,
-                            true,
-                            coins);
-
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin + params->get_h1() * intDenom);
-                }
-
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<lelantus::SigmaExtendedProof> proofs;
-                proofs.reserve(m);
-                std::vector<Scalar> challenges;
-                challenges.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.serialNumber);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.lelantusSigmaProof);
-                    challenges.emplace_back(proofData.challenge);
-                }
-
+                                                  params->get_sigma_m(), params->get_sigma_fixed_bases());
 
+    std::vector<std::map<LelantusKey, std::vector<LelantusSigmaProofData>>::const_iterator> groups;
+    for (auto itr = lelantusSigmaProofs.begin(); itr != lelantusSigmaProofs.end(); ++itr) {
+        if (!itr->second.empty())
+            groups.push_back(itr);
+    }
 
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batchverify(anonymity_set, challenges, serials, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-                
-                ++itr;
+    // Groups share the generators, so proofs of several groups are verified in a single multiexponentiation,
+    // groups are split into as many chunks as there are threads to keep all cores busy
+    WorkStealingThreadPool& pool = WorkStealingThreadPool::GetInstance();
+    std::size_t chunks = std::min(groups.size(), pool.GetNumberOfThreads() + 1);
+    WorkStealingThreadPool::TaskGroup tasks(pool);
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        tasks.Run([&sigmaVerifier, &groups, &window, chunk, chunks]() {
+            std::vector<const std::vector<GroupElement>*> anonymity_sets;
+            std::vector<std::vector<Scalar>> serials;
+            std::vector<std::vector<size_t>> setSizes;
+            std::vector<std::vector<lelantus::SigmaExtendedProof>> proofs;
+            std::vector<std::vector<Scalar>> challenges;
+
+            for (std::size_t i = chunk; i < groups.size(); i += chunks) {
+                anonymity_sets.push_back(&window.lelantusSets.at(groups[i]->first));
+
+                const std::vector<LelantusSigmaProofData>& proofData = groups[i]->second;
+                size_t m = proofData.size();
+                serials.emplace_back();
+                serials.back().reserve(m);
+                setSizes.emplace_back();
+                setSizes.back().reserve(m);
+                proofs.emplace_back();
+                proofs.back().reserve(m);
+                challenges.emplace_back();
+                challenges.back().reserve(m);
+
+                for (auto& data : proofData) {
+                    serials.back().emplace_back(data.serialNumber);
+                    setSizes.back().emplace_back(data.anonymitySetSize);
+                    proofs.back().emplace_back(data.lelantusSigmaProof);
+                    challenges.back().emplace_back(data.challenge);
+                }
             }
-        }
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
 
-        if (isFail) {
-            LogPrintf("Lelantus batch verification failed.");
-            throw std::invalid_argument("Lelantus batch verification failed, please run Firo with -reindex -batching=0");
-        }
+            return sigmaVerifier.batchverify_groups(anonymity_sets, challenges, serials, setSizes, proofs);
+        });
+    }
 
-        parallelTasks.clear();
+    if (!tasks.Wait()) {
+        LogPrintf("Lelantus batch verification failed.\n");
+        return false;
     }
-    if (!lelantusSigmaProofs.empty())
-        LogPrintf("Lelantus batch verification finished successfully.\n");
-    lelantusSigmaProofs.clear();
+
+    LogPrintf("Lelantus batch verification finished successfully.\n");
+    return true;
 }
 
-void BatchProofContainer::batch_rangeProofs() {
+bool BatchProofContainer::batch_rangeProofs(const ProofWindow& window) {
+    const auto& rangeProofs = window.rangeProofs;
     if (!rangeProofs.empty()){
         LogPrintf("RangeProof batch verification started.\n");
         uiInterface.UpdateProgressBarLabel("Batch verifying Range Proofs...");
     }
+    else
+        return true;
 
     auto params = lelantus::Params::get_default();
     for (const auto& itr : rangeProofs) {
@@ -350,6 +540,8 @@ void BatchProofContainer::batch_rangeProofs() {
         std::vector<std::vector<GroupElement>> V;
         std::vector<std::vector<GroupElement>> commitments;
         size_t proofSize = itr.second.size();
+        if (proofSize == 0)
+            continue;
         V.resize(proofSize); //size of batch
         commitments.resize(proofSize); // size of batch
         std::vector<lelantus::RangeProof> proofs;
@@ -378,12 +570,62 @@ void BatchProofContainer::batch_rangeProofs() {
 
         if (!rangeVerifier.verify(V, commitments, proofs)) {
             LogPrintf("RangeProof batch verification failed.\n");
-            throw std::invalid_argument("RangeProof batch verification failed, please run Firo with -reindex -batching=0");
+            return false;
         }
     }
 
-    if (!rangeProofs.empty())
-        LogPrintf("RangeProof batch verification finished successfully.\n");
+    LogPrintf("RangeProof batch verification finished successfully.\n");
+    return true;
+}
+
+bool BatchProofContainer::batch_mints(const ProofWindow& window) {
+    const auto& mintProofs = window.mintProofs;
+    if (!mintProofs.empty()){
+        LogPrintf("Mint Schnorr proofs batch verification started.\n");
+        uiInterface.UpdateProgressBarLabel("Batch verifying Mints...");
+    }
+    else
+        return true;
+
+    if (!verify_mints(mintProofs)) {
+        LogPrintf("Mint Schnorr proofs batch verification failed.\n");
+        return false;
+    }
+
+    LogPrintf("Mint Schnorr proofs batch verification finished successfully.\n");
+    return true;
+}
+
+bool BatchProofContainer::verify_mints(const std::vector<MintSchnorrProofData>& mintProofs) {
+    if (mintProofs.empty())
+        return true;
+
+    auto params = lelantus::Params::get_default();
+    // the challenges are already computed, so the verifier doesn't depend on nLelantusFixesStartBlock
+    lelantus::SchnorrVerifier verifier(params->get_g(), params->get_h0(), true);
+
+    // proofs are split into chunks to use all threads, every chunk is a single multiexponentiation
+    static const std::size_t MINT_PROOFS_CHUNK_SIZE = 1024;
+    DoNotDisturb dnd;
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (std::size_t begin = 0; begin < mintProofs.size(); begin += MINT_PROOFS_CHUNK_SIZE) {
+        std::size_t end = std::min(begin + MINT_PROOFS_CHUNK_SIZE, mintProofs.size());
+        tasks.Run([&verifier, &mintProofs, begin, end]() {
+            std::vector<GroupElement> comms;
+            std::vector<Scalar> challenges;
+            std::vector<lelantus::SchnorrProof> proofs;
+            comms.reserve(end - begin);
+            challenges.reserve(end - begin);
+            proofs.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                comms.emplace_back(mintProofs[i].comm);
+                challenges.emplace_back(mintProofs[i].challenge);
+                proofs.emplace_back(mintProofs[i].schnorrProof);
+            }
+
+            return verifier.batch_verify(comms, challenges, proofs);
+        });
+    }
 
-    rangeProofs.clear();
+    return tasks.Wait();
 }
@@ -1,13 +1,18 @@
 #ifndef FIRO_BATCHPROOF_CONTAINER_H
 #define FIRO_BATCHPROOF_CONTAINER_H
 
+#include <atomic>
 #include <memory>
 #include "chain.h"
 #include "sigma/coinspend.h"
 #include "liblelantus/joinsplit.h"
+#include "liblelantus/threadpool.h"
 
 extern CChain chainActive;
 
+// Default number of collected proofs after which a verification round is started
+static const size_t DEFAULT_BATCHING_WINDOW = 10000;
+
 class BatchProofContainer {
 public:
     static BatchProofContainer* get_instance();
@@ -45,11 +50,54 @@ public:
         size_t anonymitySetSize;
     };
 
+    // Schnorr proof of a lelantus mint, comm is the mint commitment without the value part,
+    // nHeight is the height of the block containing the mint, -1 until the block is connected
+    struct MintSchnorrProofData {
+        MintSchnorrProofData(const GroupElement& comm_,
+                             const Scalar& challenge_,
+                             const lelantus::SchnorrProof& schnorrProof_)
+                             : comm(comm_),
+                             challenge(challenge_),
+                             schnorrProof(schnorrProof_),
+                             nHeight(-1) {}
+
+        GroupElement comm;
+        Scalar challenge;
+        lelantus::SchnorrProof schnorrProof;
+        int nHeight;
+    };
+
+    typedef std::pair<sigma::CoinDenomination, std::pair<int, bool>> SigmaKey;
+    typedef std::pair<std::pair<uint32_t, bool>, bool> LelantusKey;
+
+    // Proofs of a contiguous block range together with the anonymity sets they are checked against,
+    // everything needed to verify them without touching the sigma/lelantus state
+    struct ProofWindow {
+        int nFirstHeight = -1;
+        int nLastHeight = -1;
+
+        std::map<SigmaKey, std::vector<SigmaProofData>> sigmaProofs;
+        std::map<LelantusKey, std::vector<LelantusSigmaProofData>> lelantusSigmaProofs;
+        std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> rangeProofs;
+        std::vector<MintSchnorrProofData> mintProofs;
+
+        std::map<SigmaKey, std::vector<GroupElement>> sigmaSets;
+        std::map<LelantusKey, std::vector<GroupElement>> lelantusSets;
+    };
+
     void init();
 
+    // merge proofs of the block connected at nHeight into the current window
+    void finalize(int nHeight);
+
+    // wait for background verification round, used on shutdown. Proofs which are left unverified
+    // are reported by getFirstUnverifiedHeight() and their blocks are connected again on the next start
     void finalize();
 
-    void verify();
+    // Verifies collected proofs if the node is synced (fCollectProofs is false) and starts a background
+    // verification round when the window is full. Returns false if some round failed,
+    // in that case blocks starting from getFailedRange().first have to be reconnected without batching
+    bool verify();
 
     void add(sigma::CoinSpend* spend,
              bool fPadding,
@@ -57,40 +105,113 @@ public:
              size_t setSize,
              bool fStartSigmaBlacklist);
 
-    void add(lelantus::JoinSplit* joinSplit,
+    void add(const lelantus::JoinSplit* joinSplit,
              const std::map<uint32_t, size_t>& setSizes,
              const Scalar& challenge,
              bool fStartLelantusBlacklist);
 
-    void add(lelantus::JoinSplit* joinSplit, const std::vector<lelantus::PublicCoin>& Cout);
+    void add(const lelantus::JoinSplit* joinSplit, const std::vector<lelantus::PublicCoin>& Cout);
+
+    void add(const GroupElement& comm, const Scalar& challenge, const lelantus::SchnorrProof& schnorrProof);
+
+    // Checks mint Schnorr proofs of the block being connected in a single batch, they are left
+    // for the window if proofs are collected
+    bool verifyMints();
+
+    // Proofs of the block being connected which are not collected for batching are verified on the thread pool
+    // while the rest of the block is processed
+    void verifyInParallel(std::function<bool()> check);
+
+    // true between init() and waitForParallelChecks(), proofs of the block may be checked after its transaction loop
+    bool isConnectingBlock() const { return blockChecks != nullptr; }
+
+    // waits for checks posted by verifyInParallel, returns false if some proof of the block is invalid
+    bool waitForParallelChecks();
 
+    // Proofs of a disconnected block are removed from both windows, the background one is taken back first
     void removeSigma(const sigma::spend_info_container& spendSerials);
     void removeLelantus(std::unordered_map<Scalar, int> spentSerials);
     void remove(const std::vector<lelantus::RangeProof>& rangeProofsToRemove);
+    // removes mint proofs of the block disconnected at nHeight, called after the rest of its proofs are removed
+    void removeBlock(int nHeight);
     void erase(std::vector<LelantusSigmaProofData>* vProofs, const Scalar& serial);
 
-    void batch_sigma();
-    void batch_lelantus();
-    void batch_rangeProofs();
+    static bool batch_sigma(const ProofWindow& window);
+    static bool batch_lelantus(const ProofWindow& window);
+    static bool batch_rangeProofs(const ProofWindow& window);
+    static bool batch_mints(const ProofWindow& window);
+
+    // true if the block at nHeight belongs to a range which failed batch verification and is being rechecked
+    bool isFailedRange(int nHeight) const;
+    std::pair<int, int> getFailedRange() const { return failedRange; }
+
+    // height of the last block with all its proofs verified
+    int getLastVerifiedHeight() const { return nLastVerifiedHeight; }
+
+    // lowest height of a connected block with collected proofs which are not verified yet or failed verification,
+    // -1 if there is none. Persisted with the chainstate, may be read from any thread
+    int getFirstUnverifiedHeight() const { return nFirstUnverifiedHeight; }
 
 public:
     bool fCollectProofs = 0;
+    // the block is only checked and not connected (block templates), cached proofs are kept for its connection
+    bool fCacheResults = false;
+
+private:
+    size_t proofsCount() const;
+    void fillAnonymitySets(ProofWindow& window) const;
+    bool verifyWindow(ProofWindow& window);
+    bool waitForBackgroundRound();
+    void reclaimBackgroundWindow();
+    void onRoundFinished(const ProofWindow& window, bool fSuccess);
+    void updateFirstUnverifiedHeight();
+    static bool verify_mints(const std::vector<MintSchnorrProofData>& mintProofs);
 
 private:
     static std::unique_ptr<BatchProofContainer> instance;
     // temp containers, to forget in case block connection fails
     // map (denom, id) to (sigma proof, serial, set size)
-    std::map<std::pair<sigma::CoinDenomination, std::pair<int, bool>>, std::vector<SigmaProofData>> tempSigmaProofs;
+    std::map<SigmaKey, std::vector<SigmaProofData>> tempSigmaProofs;
     // map ((id, afterFixes), fIsSigmaToLelantus) to (sigma proof, serial, set size, challenge)
-    std::map<std::pair<std::pair<uint32_t, bool>, bool>, std::vector<LelantusSigmaProofData>> tempLelantusSigmaProofs;
+    std::map<LelantusKey, std::vector<LelantusSigmaProofData>> tempLelantusSigmaProofs;
     // map (version to (Range proof, Pubcoins))
     std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> tempRangeProofs;
+    // (commitment without value, challenge, Schnorr proof) of mints
+    std::vector<MintSchnorrProofData> tempMintProofs;
+
+    // proof checks of the block being connected, see verifyInParallel
+    std::unique_ptr<WorkStealingThreadPool::TaskGroup> blockChecks;
+
+    // proofs collected for the current window
+    ProofWindow currentWindow;
 
-    // containers to keep proofs for batching
-    std::map<std::pair<sigma::CoinDenomination, std::pair<int, bool>>, std::vector<SigmaProofData>> sigmaProofs;
-    std::map<std::pair<std::pair<uint32_t, bool>, bool>, std::vector<LelantusSigmaProofData>> lelantusSigmaProofs;
-    std::map<unsigned int, std::vector<std::pair<lelantus::RangeProof, std::vector<lelantus::PublicCoin>>>> rangeProofs;
+    // window being verified in background, at most one at a time to keep memory bounded
+    std::unique_ptr<ProofWindow> backgroundWindow;
+    boost::future<bool> backgroundResult;
+    ParallelOpThreadPool<bool> backgroundThread{1};
 
+    int nLastVerifiedHeight = -1;
+    std::pair<int, int> failedRange{-1, -1};
+    std::atomic<int> nFirstUnverifiedHeight{-1};
+};
+
+// Starts checks of the block being connected and waits for them on every exit path of ConnectBlock,
+// so the container doesn't report a block being connected once the connection is over
+class BlockProofChecksScope {
+public:
+    explicit BlockProofChecksScope(BatchProofContainer* container_) : container(container_) {
+        container->init();
+    }
+
+    ~BlockProofChecksScope() {
+        container->waitForParallelChecks();
+    }
+
+    BlockProofChecksScope(const BlockProofChecksScope&) = delete;
+    BlockProofChecksScope& operator=(const BlockProofChecksScope&) = delete;
+
+private:
+    BatchProofContainer* container;
 };
 
 #endif //FIRO_BATCHPROOF_CONTAINER_H
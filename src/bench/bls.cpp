@@ -0,0 +1,74 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "bls/bls.h"
+#include "bls/bls_batchverifier.h"
+#include "bls/bls_worker.h"
+
+struct SigShare {
+    int nodeId;
+    uint256 msgHash;
+    CBLSSignature sig;
+    CBLSPublicKey pubKey;
+};
+
+// Sig shares of a full quorum received from several nodes, some of the nodes send invalid shares
+static std::vector<SigShare> BuildSigShares(size_t count, size_t nodes, size_t badShares)
+{
+    std::vector<SigShare> shares;
+    shares.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+
+        SigShare share;
+        share.nodeId = (int)(i % nodes);
+        // shares of a few signing sessions
+        *((uint32_t*)share.msgHash.begin()) = (uint32_t)(i % 4);
+        share.pubKey = sk.GetPublicKey();
+        share.sig = sk.Sign(share.msgHash);
+        shares.emplace_back(share);
+    }
+
+    for (size_t i = 0; i < badShares; i++) {
+        CBLSSecretKey sk;
+        sk.MakeNewKey();
+        SigShare& share = shares[(i * 7919 + 13) % count];
+        share.sig = sk.Sign(share.msgHash);
+    }
+    return shares;
+}
+
+static void VerifySigShares(benchmark::State& state, size_t badShares, bool fWorker)
+{
+    std::vector<SigShare> shares = BuildSigShares(400, 40, badShares);
+
+    CBLSWorker worker;
+    if (fWorker) {
+        worker.Start();
+    }
+
+    while (state.KeepRunning()) {
+        CBLSBatchVerifier<int, size_t> batchVerifier(false, true, 0, fWorker ? &worker : nullptr);
+        for (size_t i = 0; i < shares.size(); i++) {
+            batchVerifier.PushMessage(shares[i].nodeId, i, shares[i].msgHash, shares[i].sig, shares[i].pubKey);
+        }
+        batchVerifier.Verify();
+        assert(batchVerifier.badMessages.size() == badShares);
+    }
+
+    worker.Stop();
+}
+
+static void BLS_VerifySigShares(benchmark::State& state) { VerifySigShares(state, 0, false); }
+static void BLS_VerifySigShares_Workers(benchmark::State& state) { VerifySigShares(state, 0, true); }
+static void BLS_VerifySigShares_BadShares(benchmark::State& state) { VerifySigShares(state, 3, false); }
+static void BLS_VerifySigShares_BadShares_Workers(benchmark::State& state) { VerifySigShares(state, 3, true); }
+
+BENCHMARK(BLS_VerifySigShares);
+BENCHMARK(BLS_VerifySigShares_Workers);
+BENCHMARK(BLS_VerifySigShares_BadShares);
+BENCHMARK(BLS_VerifySigShares_BadShares_Workers);
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "bls/bls.h"
+#include "bls/bls_worker.h"
+
+#include <algorithm>
+#include <functional>
+
+// Simulated DKG session of a quorum, every phase is benchmarked on its own to get the phase latencies of one member
+struct DKG
+{
+    struct Member {
+        CBLSId id;
+        BLSVerificationVectorPtr vvec;
+        BLSSecretKeyVector skShares;
+    };
+
+    CBLSWorker& worker;
+    int threshold;
+    BLSIdVector ids;
+    std::vector<Member> members;
+
+    // received by the first member
+    std::vector<BLSVerificationVectorPtr> receivedVvecs;
+    BLSSecretKeyVector receivedSkShares;
+
+    DKG(CBLSWorker& _worker, int quorumSize) :
+        worker(_worker),
+        threshold(quorumSize * 6 / 10)
+    {
+        members.resize(quorumSize);
+        ids.reserve(quorumSize);
+        for (int i = 0; i < quorumSize; i++) {
+            uint256 id;
+            *((uint32_t*)id.begin()) = (uint32_t)(i + 1);
+            members[i].id = CBLSId(id);
+            ids.emplace_back(members[i].id);
+        }
+
+        for (auto& m : members) {
+            bool fOk = worker.GenerateContributions(threshold, ids, m.vvec, m.skShares);
+            assert(fOk);
+        }
+
+        for (auto& m : members) {
+            receivedVvecs.emplace_back(m.vvec);
+            receivedSkShares.emplace_back(m.skShares[0]);
+        }
+    }
+
+    // Phase 1, own contributions
+    void Contribute()
+    {
+        BLSVerificationVectorPtr vvec;
+        BLSSecretKeyVector skShares;
+        bool fOk = worker.GenerateContributions(threshold, ids, vvec, skShares);
+        assert(fOk);
+    }
+
+    // Phase 2, verification of the received contributions before complaining
+    void VerifyContributions(bool aggregated)
+    {
+        std::vector<bool> result = worker.VerifyContributionShares(ids[0], receivedVvecs, receivedSkShares, true, aggregated);
+        assert(std::find(result.begin(), result.end(), false) == result.end());
+    }
+
+    // Phase 4, quorum public key, own secret key share and public key shares of the other members
+    void Commit()
+    {
+        BLSVerificationVectorPtr quorumVvec = worker.BuildQuorumVerificationVector(receivedVvecs);
+        CBLSSecretKey skShare = worker.AggregateSecretKeys(receivedSkShares);
+        assert(skShare.GetPublicKey() == worker.BuildPubKeyShare(quorumVvec, ids[0]));
+    }
+};
+
+static void DKGPhase(benchmark::State& state, int quorumSize, const std::function<void(DKG&)>& phase)
+{
+    CBLSWorker worker;
+    worker.Start();
+
+    DKG dkg(worker, quorumSize);
+    while (state.KeepRunning()) {
+        phase(dkg);
+    }
+
+    worker.Stop();
+}
+
+#define BENCH_DKG(quorumSize) \
+    static void BLSDKG_Contribute_##quorumSize(benchmark::State& state) \
+    { \
+        DKGPhase(state, quorumSize, [](DKG& dkg) { dkg.Contribute(); }); \
+    } \
+    static void BLSDKG_VerifyContributions_##quorumSize(benchmark::State& state) \
+    { \
+        DKGPhase(state, quorumSize, [](DKG& dkg) { dkg.VerifyContributions(true); }); \
+    } \
+    static void BLSDKG_VerifyContributions_NotAggregated_##quorumSize(benchmark::State& state) \
+    { \
+        DKGPhase(state, quorumSize, [](DKG& dkg) { dkg.VerifyContributions(false); }); \
+    } \
+    static void BLSDKG_Commit_##quorumSize(benchmark::State& state) \
+    { \
+        DKGPhase(state, quorumSize, [](DKG& dkg) { dkg.Commit(); }); \
+    } \
+    BENCHMARK(BLSDKG_Contribute_##quorumSize); \
+    BENCHMARK(BLSDKG_VerifyContributions_##quorumSize); \
+    BENCHMARK(BLSDKG_VerifyContributions_NotAggregated_##quorumSize); \
+    BENCHMARK(BLSDKG_Commit_##quorumSize)
+
+BENCH_DKG(10);
+BENCH_DKG(50);
+BENCH_DKG(100);
@@ -8,6 +8,8 @@
 #include "validation.h"
 #include "streams.h"
 #include "consensus/validation.h"
+#include "liblelantus/joinsplit.h"
+#include "liblelantus/threadpool.h"
 
 namespace block_bench {
 #include "bench/data/block413567.raw.h"
@@ -52,5 +54,76 @@ static void DeserializeAndCheckBlockTest(benchmark::State& state)
     }
 }
 
+// Joinsplits of a block spending coins of the same anonymity set, with everything needed to verify them
+struct BlockJoinSplits {
+    std::map<uint32_t, std::vector<lelantus::PublicCoin>> anonymitySets;
+    std::vector<std::unique_ptr<lelantus::JoinSplit>> joinSplits;
+    std::vector<std::vector<lelantus::PublicCoin>> Couts;
+};
+
+static const CAmount BLOCK_JOINSPLIT_VOUT = COIN - CENT;
+
+static void BuildBlockJoinSplits(std::size_t count, BlockJoinSplits& block)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto params = lelantus::Params::get_default();
+
+    std::vector<lelantus::PublicCoin>& set = block.anonymitySets[1];
+    for (std::size_t i = 0; i < 1024; ++i) {
+        GroupElement coin;
+        coin.randomize();
+        set.emplace_back(coin);
+    }
+
+    std::vector<lelantus::PrivateCoin> inputs;
+    for (std::size_t i = 0; i < count; ++i) {
+        inputs.emplace_back(params, 2 * COIN);
+        inputs.back().setVersion(LELANTUS_TX_TPAYLOAD);
+        set[i * set.size() / count] = inputs.back().getPublicCoin();
+    }
+
+    std::map<uint32_t, uint256> groupBlockHashes = {{1, ArithToUint256(1)}};
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<lelantus::PrivateCoin> Cout = {lelantus::PrivateCoin(params, COIN)};
+        block.joinSplits.emplace_back(new lelantus::JoinSplit(params, {{inputs[i], 1}}, block.anonymitySets, {},
+            BLOCK_JOINSPLIT_VOUT, Cout, CENT, groupBlockHashes, ArithToUint256(i), LELANTUS_TX_TPAYLOAD));
+        block.Couts.push_back({Cout[0].getPublicCoin()});
+    }
+}
+
+// Proofs of a block verified one after another, as they were checked under cs_main
+static void VerifyBlockJoinSplitsSequential(benchmark::State& state)
+{
+    BlockJoinSplits block;
+    BuildBlockJoinSplits(8, block);
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < block.joinSplits.size(); ++i) {
+            bool fValid = block.joinSplits[i]->Verify(block.anonymitySets, {}, block.Couts[i], BLOCK_JOINSPLIT_VOUT, ArithToUint256(i));
+            assert(fValid);
+        }
+    }
+}
+
+// Proofs of a block verified on the thread pool, as ConnectBlock does through BatchProofContainer::verifyInParallel
+static void VerifyBlockJoinSplitsParallel(benchmark::State& state)
+{
+    BlockJoinSplits block;
+    BuildBlockJoinSplits(8, block);
+
+    while (state.KeepRunning()) {
+        WorkStealingThreadPool::TaskGroup tasks;
+        for (std::size_t i = 0; i < block.joinSplits.size(); ++i) {
+            tasks.Run([&block, i]() {
+                return block.joinSplits[i]->Verify(block.anonymitySets, {}, block.Couts[i], BLOCK_JOINSPLIT_VOUT, ArithToUint256(i));
+            });
+        }
+        bool fValid = tasks.Wait();
+        assert(fValid);
+    }
+}
+
 BENCHMARK(DeserializeBlockTest);
 BENCHMARK(DeserializeAndCheckBlockTest);
+BENCHMARK(VerifyBlockJoinSplitsSequential);
+BENCHMARK(VerifyBlockJoinSplitsParallel);
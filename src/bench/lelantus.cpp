@@ -0,0 +1,223 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainparams.h"
+#include "liblelantus/challenge_generator_impl.h"
+#include "liblelantus/joinsplit.h"
+#include "liblelantus/schnorr_prover.h"
+#include "liblelantus/schnorr_verifier.h"
+#include "liblelantus/sigmaextended_prover.h"
+#include "liblelantus/sigmaextended_verifier.h"
+#include "liblelantus/threadpool.h"
+
+// Anonymity set of the maximal size, filled without hashing to keep setup fast
+static std::vector<GroupElement> BuildAnonymitySet(std::size_t size)
+{
+    GroupElement base, step;
+    base.randomize();
+    step.randomize();
+
+    std::vector<GroupElement> set;
+    set.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        set.emplace_back(base);
+        base += step;
+    }
+    return set;
+}
+
+static void AnonymitySetCopy(benchmark::State& state)
+{
+    std::vector<GroupElement> set = BuildAnonymitySet(65536);
+
+    while (state.KeepRunning()) {
+        std::vector<GroupElement> copy(set);
+        assert(copy.size() == set.size());
+    }
+}
+
+static void AnonymitySetConstruction(benchmark::State& state)
+{
+    std::vector<GroupElement> coins = BuildAnonymitySet(65536);
+    GroupElement offset;
+    offset.randomize();
+
+    while (state.KeepRunning()) {
+        // same as building sigma-to-lelantus sets with denomination added to every coin
+        std::vector<GroupElement> set;
+        set.reserve(coins.size());
+        for (const auto& coin : coins)
+            set.emplace_back(coin + offset);
+    }
+}
+
+static void SigmaExtendedBatchVerify(benchmark::State& state)
+{
+    std::size_t n = 16, m = 3, N = 4096, proofsCount = 10;
+
+    GroupElement g;
+    g.randomize();
+    std::vector<GroupElement> h_gens(n * m);
+    for (auto& h : h_gens)
+        h.randomize();
+
+    std::vector<GroupElement> commits = BuildAnonymitySet(N);
+    lelantus::SigmaExtendedProver prover(g, h_gens, n, m);
+
+    std::vector<Scalar> challenges(proofsCount), serials(proofsCount), values(proofsCount), randoms(proofsCount);
+    std::vector<std::size_t> setSizes(proofsCount, N);
+    for (std::size_t i = 0; i < proofsCount; ++i) {
+        serials[i].randomize();
+        values[i].randomize();
+        randoms[i].randomize();
+        challenges[i].randomize();
+        commits[i * (N / proofsCount)] = lelantus::LelantusPrimitives::double_commit(
+            g, serials[i], h_gens[1], values[i], h_gens[0], randoms[i]);
+    }
+
+    std::vector<lelantus::SigmaExtendedProof> proofs(proofsCount);
+    for (std::size_t i = 0; i < proofsCount; ++i) {
+        GroupElement gs = g * serials[i].negate();
+        std::vector<GroupElement> shifted(commits);
+        for (auto& c : shifted)
+            c += gs;
+
+        Scalar rA, rB, rC, rD;
+        rA.randomize();
+        rB.randomize();
+        rC.randomize();
+        rD.randomize();
+        std::vector<Scalar> sigma, Tk(m), Pk(m), Yk(m), a(n * m);
+        prover.sigma_commit(shifted, i * (N / proofsCount), rA, rB, rC, rD, a, Tk, Pk, Yk, sigma, proofs[i]);
+        prover.sigma_response(sigma, a, rA, rB, rC, rD, values[i], randoms[i], Tk, Pk, challenges[i], proofs[i]);
+    }
+
+    lelantus::SigmaExtendedVerifier verifier(g, h_gens, n, m);
+    while (state.KeepRunning()) {
+        bool fValid = verifier.batchverify(commits, challenges, serials, setSizes, proofs);
+        assert(fValid);
+    }
+}
+
+// Spend of two coins from a full anonymity set, with the shared thread pool limited to the given number of threads
+static void JoinSplitCreate(benchmark::State& state, std::size_t threads)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto params = lelantus::Params::get_default();
+    std::size_t N = (std::size_t)pow(params->get_sigma_n(), params->get_sigma_m());
+
+    std::vector<lelantus::PrivateCoin> inputs = {
+        lelantus::PrivateCoin(params, 1 * COIN),
+        lelantus::PrivateCoin(params, 2 * COIN)
+    };
+
+    std::vector<lelantus::PublicCoin> set;
+    set.reserve(N);
+    for (const auto& coin : BuildAnonymitySet(N))
+        set.emplace_back(coin);
+
+    std::vector<std::pair<lelantus::PrivateCoin, uint32_t>> Cin;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        inputs[i].setVersion(LELANTUS_TX_TPAYLOAD);
+        set[i * N / inputs.size()] = inputs[i].getPublicCoin();
+        Cin.emplace_back(inputs[i], 1);
+    }
+
+    std::map<uint32_t, std::vector<lelantus::PublicCoin>> anonymitySets = {{1, set}};
+    std::map<uint32_t, uint256> groupBlockHashes = {{1, ArithToUint256(1)}};
+    std::vector<lelantus::PrivateCoin> Cout = {lelantus::PrivateCoin(params, 2 * COIN)};
+
+    WorkStealingThreadPool& pool = WorkStealingThreadPool::GetInstance();
+    std::size_t poolThreads = pool.GetNumberOfThreads();
+    // thread waiting for the proof runs tasks too
+    pool.SetNumberOfThreads(threads - 1);
+
+    while (state.KeepRunning()) {
+        lelantus::JoinSplit joinSplit(params, Cin, anonymitySets, {}, COIN - CENT, Cout, CENT, groupBlockHashes,
+            ArithToUint256(2), LELANTUS_TX_TPAYLOAD);
+    }
+
+    pool.SetNumberOfThreads(poolThreads);
+}
+
+static void JoinSplitCreate_1Thread(benchmark::State& state) { JoinSplitCreate(state, 1); }
+static void JoinSplitCreate_2Threads(benchmark::State& state) { JoinSplitCreate(state, 2); }
+static void JoinSplitCreate_4Threads(benchmark::State& state) { JoinSplitCreate(state, 4); }
+static void JoinSplitCreate_8Threads(benchmark::State& state) { JoinSplitCreate(state, 8); }
+
+// Schnorr proofs of a block full of mints
+static void BuildSchnorrProofs(std::size_t count, const GroupElement& g, const GroupElement& h, const GroupElement& a,
+        const GroupElement& b, std::vector<GroupElement>& ys, std::vector<lelantus::SchnorrProof>& proofs)
+{
+    lelantus::SchnorrProver prover(g, h, true);
+
+    ys.resize(count);
+    proofs.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        Scalar p, t;
+        p.randomize();
+        t.randomize();
+        ys[i] = lelantus::LelantusPrimitives::commit(g, p, h, t);
+
+        std::unique_ptr<lelantus::ChallengeGenerator> challengeGenerator = std::make_unique<lelantus::ChallengeGeneratorImpl<CHash256>>(1);
+        prover.proof(p, t, ys[i], a, b, challengeGenerator, proofs[i]);
+    }
+}
+
+static void SchnorrVerify(benchmark::State& state)
+{
+    GroupElement g, h, a, b;
+    g.randomize();
+    h.randomize();
+    a.randomize();
+    b.randomize();
+    std::vector<GroupElement> ys;
+    std::vector<lelantus::SchnorrProof> proofs;
+    BuildSchnorrProofs(500, g, h, a, b, ys, proofs);
+
+    lelantus::SchnorrVerifier verifier(g, h, true);
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < proofs.size(); ++i) {
+            std::unique_ptr<lelantus::ChallengeGenerator> challengeGenerator = std::make_unique<lelantus::ChallengeGeneratorImpl<CHash256>>(1);
+            bool fValid = verifier.verify(ys[i], a, b, proofs[i], challengeGenerator);
+            assert(fValid);
+        }
+    }
+}
+
+static void SchnorrBatchVerify(benchmark::State& state)
+{
+    GroupElement g, h, a, b;
+    g.randomize();
+    h.randomize();
+    a.randomize();
+    b.randomize();
+    std::vector<GroupElement> ys;
+    std::vector<lelantus::SchnorrProof> proofs;
+    BuildSchnorrProofs(500, g, h, a, b, ys, proofs);
+
+    lelantus::SchnorrVerifier verifier(g, h, true);
+    std::vector<Scalar> challenges(proofs.size());
+    while (state.KeepRunning()) {
+        // challenges are computed per proof in block connection too
+        for (std::size_t i = 0; i < proofs.size(); ++i) {
+            std::unique_ptr<lelantus::ChallengeGenerator> challengeGenerator = std::make_unique<lelantus::ChallengeGeneratorImpl<CHash256>>(1);
+            verifier.get_challenge(ys[i], a, b, proofs[i], challengeGenerator, challenges[i]);
+        }
+        bool fValid = verifier.batch_verify(ys, challenges, proofs);
+        assert(fValid);
+    }
+}
+
+BENCHMARK(AnonymitySetCopy);
+BENCHMARK(AnonymitySetConstruction);
+BENCHMARK(SigmaExtendedBatchVerify);
+BENCHMARK(SchnorrVerify);
+BENCHMARK(SchnorrBatchVerify);
+BENCHMARK(JoinSplitCreate_1Thread);
+BENCHMARK(JoinSplitCreate_2Threads);
+BENCHMARK(JoinSplitCreate_4Threads);
+BENCHMARK(JoinSplitCreate_8Threads);
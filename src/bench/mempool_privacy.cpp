@@ -0,0 +1,61 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "arith_uint256.h"
+#include "lelantus.h"
+
+// Serials and mints a joinsplit spending two coins to two jmints adds to the mempool state
+struct MempoolJoinSplit {
+    uint256 txHash;
+    std::vector<Scalar> serials;
+    std::vector<GroupElement> mints;
+};
+
+static std::vector<MempoolJoinSplit> BuildJoinSplits(std::size_t count)
+{
+    std::vector<MempoolJoinSplit> joinSplits(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        joinSplits[i].txHash = ArithToUint256(i + 1);
+        joinSplits[i].serials.resize(2);
+        joinSplits[i].mints.resize(2);
+        for (std::size_t j = 0; j < 2; ++j) {
+            joinSplits[i].serials[j].randomize();
+            joinSplits[i].mints[j].randomize();
+        }
+    }
+    return joinSplits;
+}
+
+// Joinsplits are accepted with their conflict checks, a block spending the coins of every tenth of them is
+// connected and the rest is evicted
+static void MempoolJoinSplitChurn(benchmark::State& state)
+{
+    std::vector<MempoolJoinSplit> joinSplits = BuildJoinSplits(1000);
+
+    std::vector<Scalar> blockSerials;
+    for (std::size_t i = 0; i < joinSplits.size(); i += 10)
+        blockSerials.insert(blockSerials.end(), joinSplits[i].serials.begin(), joinSplits[i].serials.end());
+
+    lelantus::CLelantusMempoolState mempoolState;
+
+    while (state.KeepRunning()) {
+        for (const auto& joinSplit : joinSplits) {
+            for (const auto& serial : joinSplit.serials)
+                assert(!mempoolState.HasCoinSerial(serial));
+            for (const auto& mint : joinSplit.mints)
+                assert(!mempoolState.HasMint(mint));
+            mempoolState.AddTransaction(joinSplit.txHash, joinSplit.serials, joinSplit.mints);
+        }
+
+        std::set<uint256> conflicting = mempoolState.GetConflictingTxs(blockSerials, {});
+        assert(conflicting.size() == joinSplits.size() / 10);
+
+        for (const auto& joinSplit : joinSplits)
+            mempoolState.RemoveTransaction(joinSplit.txHash);
+    }
+}
+
+BENCHMARK(MempoolJoinSplitChurn);
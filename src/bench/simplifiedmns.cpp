@@ -0,0 +1,80 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "evo/deterministicmns.h"
+#include "evo/simplifiedmns.h"
+#include "random.h"
+
+static void AddBenchMN(CDeterministicMNList& mnList)
+{
+    auto dmn = std::make_shared<CDeterministicMN>();
+    dmn->proTxHash = GetRandHash();
+    dmn->internalId = mnList.GetTotalRegisteredCount();
+    dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+    auto state = std::make_shared<CDeterministicMNState>();
+    state->keyIDOwner = CKeyID(uint160(std::vector<unsigned char>(dmn->proTxHash.begin(), dmn->proTxHash.begin() + 20)));
+    state->confirmedHash = GetRandHash();
+    dmn->pdmnState = state;
+
+    mnList.AddMN(dmn);
+    mnList.SetTotalRegisteredCount(mnList.GetTotalRegisteredCount() + 1);
+}
+
+// Lists of two consecutive blocks of a network with thousands of znodes, the block changes a few of them
+static void BuildBenchLists(CDeterministicMNList& prevList, CDeterministicMNList& list)
+{
+    prevList = CDeterministicMNList(uint256(), 0, 0);
+    for (size_t i = 0; i < 4000; i++) {
+        AddBenchMN(prevList);
+    }
+
+    list = prevList;
+    for (size_t i = 0; i < 2; i++) {
+        AddBenchMN(list);
+    }
+    size_t n = 0;
+    prevList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+        if (n++ % 1000 == 0) {
+            auto state = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+            state->confirmedHash = GetRandHash();
+            list.UpdateMN(dmn->proTxHash, state);
+        }
+    });
+}
+
+static void SimplifiedMNListMerkleRoot(benchmark::State& state)
+{
+    CDeterministicMNList prevList, list;
+    BuildBenchLists(prevList, list);
+
+    bool fFlip = false;
+    while (state.KeepRunning()) {
+        CSimplifiedMNList sml(fFlip ? prevList : list);
+        sml.CalcMerkleRoot();
+        fFlip = !fFlip;
+    }
+}
+
+static void SimplifiedMNListMerkleTreeUpdate(benchmark::State& state)
+{
+    CDeterministicMNList prevList, list;
+    BuildBenchLists(prevList, list);
+
+    CSimplifiedMNListMerkleTree tree;
+    tree.Build(prevList);
+    assert(tree.GetMerkleRoot() == CSimplifiedMNList(prevList).CalcMerkleRoot());
+
+    // connecting and disconnecting the block
+    bool fFlip = false;
+    while (state.KeepRunning()) {
+        tree.Update(fFlip ? list : prevList, fFlip ? prevList : list);
+        tree.GetMerkleRoot();
+        fFlip = !fFlip;
+    }
+}
+
+BENCHMARK(SimplifiedMNListMerkleRoot);
+BENCHMARK(SimplifiedMNListMerkleTreeUpdate);
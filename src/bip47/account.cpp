@@ -251,7 +251,7 @@ bool CAccountReceiver::acceptMaskedPayload(std::vector<unsigned char> const & ma
 
 bool CAccountReceiver::acceptMaskedPayload(std::vector<unsigned char> const & maskedPayload, CTransaction const & tx)
 {
-    std::unique_ptr<lelantus::JoinSplit> jsplit;
+    std::shared_ptr<const lelantus::JoinSplit> jsplit;
     try {
         jsplit = lelantus::ParseLelantusJoinSplit(tx);
     }catch (...) {
@@ -6,8 +6,12 @@
 #define DASH_CRYPTO_BLS_BATCHVERIFIER_H
 
 #include <bls/bls.h>
+#include <bls/bls_worker.h>
 
+#include <algorithm>
+#include <future>
 #include <map>
+#include <memory>
 #include <vector>
 
 template<typename SourceId, typename MessageId>
@@ -24,10 +28,15 @@ private:
     typedef std::map<MessageId, Message> MessageMap;
     typedef typename MessageMap::iterator MessageMapIterator;
     typedef std::map<SourceId, std::vector<MessageMapIterator>> MessagesBySourceMap;
+    typedef std::map<uint256, std::vector<MessageMapIterator>> MessagesByHashMap;
+    // range [first, second) of message groups verified as a single batch
+    typedef std::pair<size_t, size_t> GroupRange;
 
     bool secureVerification;
     bool perMessageFallback;
     size_t subBatchSize;
+    // sub-batches are verified on the worker threads if set, on the calling thread otherwise
+    CBLSWorker* worker;
 
     MessageMap messages;
     MessagesBySourceMap messagesBySource;
@@ -37,10 +46,11 @@ public:
     std::set<MessageId> badMessages;
 
 public:
-    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0) :
+    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0, CBLSWorker* _worker = nullptr) :
             secureVerification(_secureVerification),
             perMessageFallback(_perMessageFallback),
-            subBatchSize(_subBatchSize)
+            subBatchSize(_subBatchSize),
+            worker(_worker)
     {
     }
 
@@ -68,58 +78,125 @@ public:
         return messagesBySource.size();
     }
 
+    // Sources are split into one sub-batch per worker thread and verified in parallel. Failing sub-batches are
+    // bisected until the bad sources are found, so k bad sources out of n cost O(k log n) batch verifications
+    // instead of n. Messages of bad sources are bisected the same way if perMessageFallback is set
     void Verify()
     {
-        std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
+        if (messages.empty()) {
+            return;
+        }
+
+        std::vector<SourceId> sourceIds;
+        std::vector<std::vector<MessageMapIterator>> sourceMessages;
+        sourceIds.reserve(messagesBySource.size());
+        sourceMessages.reserve(messagesBySource.size());
+        for (const auto& p : messagesBySource) {
+            sourceIds.emplace_back(p.first);
+            sourceMessages.emplace_back(p.second);
+        }
 
-        for (auto it = messages.begin(); it != messages.end(); ++it) {
-            byMessageHash[it->second.msgHash].emplace_back(it);
+        size_t batchCount = std::max<size_t>(1, std::min<size_t>(sourceIds.size(), worker ? worker->GetWorkerCount() : 1));
+        std::vector<GroupRange> ranges;
+        for (size_t i = 0; i < batchCount; i++) {
+            ranges.emplace_back(i * sourceIds.size() / batchCount, (i + 1) * sourceIds.size() / batchCount);
         }
 
-        if (VerifyBatch(byMessageHash)) {
+        std::vector<size_t> badSourceIndexes = FindInvalidGroups(sourceMessages, ranges);
+        if (badSourceIndexes.empty()) {
             // full batch is valid
             return;
         }
 
-        // revert to per-source verification
-        for (const auto& p : messagesBySource) {
-            bool batchValid = false;
+        std::vector<std::vector<MessageMapIterator>> messagesToCheck;
+        ranges.clear();
+        for (size_t i : badSourceIndexes) {
+            badSources.emplace(sourceIds[i]);
+
+            if (!perMessageFallback) {
+                continue;
+            }
+
+            const auto& v = sourceMessages[i];
+            if (v.size() == 1) {
+                // no need to re-verify a single message
+                badMessages.emplace(v[0]->second.msgId);
+                continue;
+            }
+
+            // messages of a bad source are bisected in their own range
+            size_t first = messagesToCheck.size();
+            for (const auto& msgIt : v) {
+                messagesToCheck.push_back({msgIt});
+            }
+            ranges.emplace_back(first, messagesToCheck.size());
+        }
+
+        for (size_t i : FindInvalidGroups(messagesToCheck, ranges)) {
+            badMessages.emplace(messagesToCheck[i][0]->second.msgId);
+        }
+    }
 
-            // no need to verify it again if there was just one source
-            if (messagesBySource.size() != 1) {
-                byMessageHash.clear();
-                for (auto it = p.second.begin(); it != p.second.end(); ++it) {
-                    byMessageHash[(*it)->second.msgHash].emplace_back(*it);
+private:
+    // Verifies every range as a single batch, failing ranges are split in halves which are verified again
+    // until single invalid groups remain. Returns indexes of invalid groups
+    std::vector<size_t> FindInvalidGroups(const std::vector<std::vector<MessageMapIterator>>& groups, std::vector<GroupRange> ranges)
+    {
+        std::vector<size_t> invalidGroups;
+        while (!ranges.empty()) {
+            std::vector<bool> results = VerifyRanges(groups, ranges);
+
+            std::vector<GroupRange> halves;
+            for (size_t i = 0; i < ranges.size(); i++) {
+                if (results[i]) {
+                    continue;
+                }
+
+                const auto& r = ranges[i];
+                if (r.second - r.first == 1) {
+                    invalidGroups.emplace_back(r.first);
+                } else {
+                    size_t mid = r.first + (r.second - r.first) / 2;
+                    halves.emplace_back(r.first, mid);
+                    halves.emplace_back(mid, r.second);
                 }
-                batchValid = VerifyBatch(byMessageHash);
             }
-            if (!batchValid) {
-                badSources.emplace(p.first);
-
-                if (perMessageFallback) {
-                    // revert to per-message verification
-                    if (p.second.size() == 1) {
-                        // no need to re-verify a single message
-                        badMessages.emplace(p.second[0]->second.msgId);
-                    } else {
-                        for (const auto& msgIt : p.second) {
-                            if (badMessages.count(msgIt->first)) {
-                                // same message might be invalid from different source, so no need to re-verify it
-                                continue;
-                            }
-
-                            const auto& msg = msgIt->second;
-                            if (!msg.sig.VerifyInsecure(msg.pubKey, msg.msgHash)) {
-                                badMessages.emplace(msg.msgId);
-                            }
-                        }
-                    }
+            ranges = std::move(halves);
+        }
+        std::sort(invalidGroups.begin(), invalidGroups.end());
+        return invalidGroups;
+    }
+
+    std::vector<bool> VerifyRanges(const std::vector<std::vector<MessageMapIterator>>& groups, const std::vector<GroupRange>& ranges)
+    {
+        std::vector<bool> results(ranges.size());
+        std::vector<std::future<bool>> futures;
+        futures.reserve(ranges.size());
+
+        for (size_t i = 0; i < ranges.size(); i++) {
+            auto byMessageHash = std::make_shared<MessagesByHashMap>();
+            for (size_t j = ranges[i].first; j < ranges[i].second; j++) {
+                for (const auto& msgIt : groups[j]) {
+                    (*byMessageHash)[msgIt->second.msgHash].emplace_back(msgIt);
                 }
             }
+
+            // the last range is verified here while the worker threads process the others
+            if (worker && i + 1 < ranges.size()) {
+                futures.emplace_back(worker->AsyncVerifyBatch([this, byMessageHash]() {
+                    return VerifyBatch(*byMessageHash);
+                }));
+            } else {
+                results[i] = VerifyBatch(*byMessageHash);
+            }
+        }
+
+        for (size_t i = 0; i < futures.size(); i++) {
+            results[i] = futures[i].get();
         }
+        return results;
     }
 
-private:
     // All Verify methods take ownership of the passed byMessageHash map and thus might modify the map. This is to avoid
     // unnecessary copies
 
@@ -887,6 +887,23 @@ bool CBLSWorker::IsAsyncVerifyInProgress()
     return sigVerifyBatchesInProgress != 0;
 }
 
+size_t CBLSWorker::GetWorkerCount()
+{
+    return (size_t)workerPool.size();
+}
+
+std::future<bool> CBLSWorker::AsyncVerifyBatch(std::function<bool()> job)
+{
+    if (workerPool.size() == 0) {
+        std::promise<bool> p;
+        p.set_value(job());
+        return p.get_future();
+    }
+    return workerPool.push([job](int threadId) {
+        return job();
+    });
+}
+
 // sigVerifyMutex must be held while calling
 void CBLSWorker::PushSigVerifyBatch()
 {
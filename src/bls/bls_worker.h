@@ -139,6 +139,11 @@ public:
     std::future<bool> AsyncVerifySig(const CBLSSignature& sig, const CBLSPublicKey& pubKey, const uint256& msgHash, CancelCond cancelCond = [] { return false; });
     bool IsAsyncVerifyInProgress();
 
+    // Runs a sub-batch verification of CBLSBatchVerifier on the worker threads. The job is run on the calling
+    // thread if the worker is not started
+    std::future<bool> AsyncVerifyBatch(std::function<bool()> job);
+    size_t GetWorkerCount();
+
 private:
     void PushSigVerifyBatch();
 };
@@ -179,6 +184,15 @@ public:
             return worker.BuildPubKeyShare(vvec, id);
         });
     }
+    // Adds a public key share which was built before, e.g. read from disk
+    void AddPubKeyShare(const uint256& cacheKey, const CBLSPublicKey& pubKeyShare)
+    {
+        std::promise<CBLSPublicKey> p;
+        p.set_value(pubKeyShare);
+
+        std::unique_lock<std::mutex> l(cacheCs);
+        publicKeyShareCache.emplace(cacheKey, p.get_future());
+    }
 
 private:
     template <typename T, typename Builder>
@@ -226,31 +226,32 @@ public:
     //! (memory only) Maximum nTime in the chain upto and including this block.
     unsigned int nTimeMax;
 
-    //! Public coin values of mints in this block, ordered by serialized value of public coin
-    //! Maps <denomination,id> to vector of public coins
-    std::map<std::pair<int,int>, std::vector<CBigNum>> mintedPubCoins;
-
-    //! Accumulator updates. Contains only changes made by mints in this block
-    //! Maps <denomination, id> to <accumulator value (CBigNum), number of such mints in this block>
-    std::map<std::pair<int,int>, std::pair<CBigNum,int>> accumulatorChanges;
-
-    //! Values of coin serials spent in this block
-	std::set<CBigNum> spentSerials;
-
 /////////////////////// Sigma index entries. ////////////////////////////////////////////
 
+    //! Sigma and lelantus mints and spends of this block (the privacy payload). Blocks loaded from the
+    //! block tree db keep them in its privacy payload index until LoadPrivacyPayload() reads them back
+
     //! Public coin values of mints in this block, ordered by serialized value of public coin
     //! Maps <denomination,id> to vector of public coins
     std::map<std::pair<sigma::CoinDenomination, int>, std::vector<sigma::PublicCoin>> sigmaMintedPubCoins;
     //! Map id to <public coin, tag>
     std::map<int, std::vector<std::pair<lelantus::PublicCoin, uint256>>>  lelantusMintedPubCoins;
-    //! Map id to <hash of the set>
-    std::map<int, std::vector<unsigned char>> anonymitySetHash;
 
     //! Values of coin serials spent in this block
     sigma::spend_info_container sigmaSpentSerials;
     std::unordered_map<Scalar, int> lelantusSpentSerials;
 
+    //! (memory only) Whether the privacy payload above is in memory
+    bool fPrivacyPayloadLoaded;
+
+    //! Summary of the lelantus mints of this block, valid while the privacy payload is not in memory.
+    //! -1 if the summary is unknown or the mints belong to more than one coin group
+    int nLelantusMintsGroupId;
+    unsigned int nLelantusMints;
+
+    //! Map id to <hash of the set>
+    std::map<int, std::vector<unsigned char>> anonymitySetHash;
+
     //! list of disabling sporks active at this block height
     //! std::map {feature name} -> {block number when feature is re-enabled again, parameter}
     ActiveSporkMap activeDisablingSporks;
@@ -290,9 +291,27 @@ public:
         anonymitySetHash.clear();
         sigmaSpentSerials.clear();
         lelantusSpentSerials.clear();
+        fPrivacyPayloadLoaded = true;
+        nLelantusMintsGroupId = 0;
+        nLelantusMints = 0;
         activeDisablingSporks.clear();
     }
 
+    bool HasPrivacyPayload() const
+    {
+        return !sigmaMintedPubCoins.empty() || !lelantusMintedPubCoins.empty()
+            || !sigmaSpentSerials.empty() || !lelantusSpentSerials.empty();
+    }
+
+    void ClearPrivacyPayload()
+    {
+        sigmaMintedPubCoins.clear();
+        lelantusMintedPubCoins.clear();
+        // release the bucket arrays too
+        decltype(sigmaSpentSerials)().swap(sigmaSpentSerials);
+        decltype(lelantusSpentSerials)().swap(lelantusSpentSerials);
+    }
+
     CBlockIndex()
     {
         SetNull();
@@ -452,13 +471,44 @@ public:
     uint256 hashPrev;
     int nDiskBlockVersion;
 
+    //! Legacy zerocoin entries, read from old records only to skip over them
+    std::map<std::pair<int,int>, std::vector<CBigNum>> mintedPubCoins;
+    std::map<std::pair<int,int>, std::pair<CBigNum,int>> accumulatorChanges;
+    std::set<CBigNum> spentSerials;
+
     CDiskBlockIndex() {
         hashPrev = uint256();
         // value doesn't really matter but we won't leave it uninitialized
         nDiskBlockVersion = 0;
     }
 
-    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
+    // privacy payload is written to its own index (see CBlockTreeDB::WriteBatchSync), so only the fields
+    // serialized below are copied and the payload maps are left empty
+    explicit CDiskBlockIndex(const CBlockIndex* pindex) {
+        phashBlock = pindex->phashBlock;
+        pprev = pindex->pprev;
+        nHeight = pindex->nHeight;
+        nStatus = pindex->nStatus;
+        nTx = pindex->nTx;
+        nFile = pindex->nFile;
+        nDataPos = pindex->nDataPos;
+        nUndoPos = pindex->nUndoPos;
+
+        nVersion = pindex->nVersion;
+        hashMerkleRoot = pindex->hashMerkleRoot;
+        nTime = pindex->nTime;
+        nBits = pindex->nBits;
+        nNonce = pindex->nNonce;
+        nNonce64 = pindex->nNonce64;
+        mix_hash = pindex->mix_hash;
+        nVersionMTP = pindex->nVersionMTP;
+        mtpHashValue = pindex->mtpHashValue;
+        reserved[0] = pindex->reserved[0];
+        reserved[1] = pindex->reserved[1];
+
+        anonymitySetHash = pindex->anonymitySetHash;
+        activeDisablingSporks = pindex->activeDisablingSporks;
+
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
         nDiskBlockVersion = 0;
     }
@@ -588,6 +638,43 @@ public:
     }
 };
 
+/** Sigma and lelantus mints and spends of a block, stored apart from its block index entry so they
+ *  don't have to be read and kept in memory for every block at startup. */
+class CDiskBlockPrivacyPayload
+{
+public:
+    std::map<std::pair<sigma::CoinDenomination, int>, std::vector<sigma::PublicCoin>> sigmaMintedPubCoins;
+    sigma::spend_info_container sigmaSpentSerials;
+    std::map<int, std::vector<std::pair<lelantus::PublicCoin, uint256>>> lelantusMintedPubCoins;
+    std::unordered_map<Scalar, int> lelantusSpentSerials;
+
+    CDiskBlockPrivacyPayload() {}
+
+    explicit CDiskBlockPrivacyPayload(const CBlockIndex* pindex) :
+        sigmaMintedPubCoins(pindex->sigmaMintedPubCoins),
+        sigmaSpentSerials(pindex->sigmaSpentSerials),
+        lelantusMintedPubCoins(pindex->lelantusMintedPubCoins),
+        lelantusSpentSerials(pindex->lelantusSpentSerials) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(sigmaMintedPubCoins);
+        READWRITE(sigmaSpentSerials);
+        READWRITE(lelantusMintedPubCoins);
+        READWRITE(lelantusSpentSerials);
+    }
+
+    void MoveTo(CBlockIndex* pindex)
+    {
+        pindex->sigmaMintedPubCoins = std::move(sigmaMintedPubCoins);
+        pindex->sigmaSpentSerials = std::move(sigmaSpentSerials);
+        pindex->lelantusMintedPubCoins = std::move(lelantusMintedPubCoins);
+        pindex->lelantusSpentSerials = std::move(lelantusSpentSerials);
+    }
+};
+
 /** An in-memory indexed chain of blocks. */
 class CChain {
 private:
@@ -21,6 +21,31 @@
 static const std::string DB_LIST_SNAPSHOT = "dmn_S";
 static const std::string DB_LIST_DIFF = "dmn_D";
 
+// Lists derived from each other share immer map nodes and CDeterministicMN objects, so a list built by applying a diff
+// to a cached list is accounted for the copied nodes only, and for all of its entries once that base list is evicted
+static const size_t MNLIST_MEMORY_USAGE_DMN = sizeof(CDeterministicMN) + sizeof(CDeterministicMNState);
+// an entry in mnMap, in mnInternalIdMap and about four unique properties per znode
+static const size_t MNLIST_MEMORY_USAGE_ENTRY = sizeof(std::pair<uint256, CDeterministicMNCPtr>) +
+        sizeof(std::pair<uint64_t, uint256>) + 4 * sizeof(std::pair<uint256, std::pair<uint256, uint32_t>>);
+// changing an entry copies one inner node of up to 32 children per level, in about six maps
+static const size_t MNLIST_MEMORY_USAGE_CHANGE = 6 * 32 * sizeof(void*);
+
+static size_t EstimateListMemoryUsage(const CDeterministicMNList& mnList)
+{
+    return sizeof(CDeterministicMNList) + mnList.GetAllMNsCount() * (MNLIST_MEMORY_USAGE_ENTRY + MNLIST_MEMORY_USAGE_DMN);
+}
+
+static size_t EstimateDiffMemoryUsage(const CDeterministicMNList& mnList, const CDeterministicMNListDiff& diff)
+{
+    size_t nDepth = 1;
+    for (size_t n = mnList.GetAllMNsCount(); n > 32; n /= 32) {
+        nDepth++;
+    }
+    size_t nChanges = diff.addedMNs.size() + diff.updatedMNs.size() + diff.removedMns.size();
+    size_t nNewObjects = diff.addedMNs.size() + diff.updatedMNs.size();
+    return sizeof(CDeterministicMNList) + nChanges * nDepth * MNLIST_MEMORY_USAGE_CHANGE + nNewObjects * MNLIST_MEMORY_USAGE_DMN;
+}
+
 CDeterministicMNManager* deterministicMNManager;
 
 std::string CDeterministicMNState::ToString() const
@@ -499,8 +524,17 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
 }
 
 CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb) :
-    evoDb(_evoDb)
+    CDeterministicMNManager(_evoDb, std::max((int64_t)0, GetArg("-maxmnlistscachesize", DEFAULT_MAX_MNLISTS_CACHE_SIZE)) * ((size_t)1 << 20))
+{
+}
+
+CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb, size_t _nMaxListsCacheMemoryUsage) :
+    evoDb(_evoDb),
+    nMaxListsCacheMemoryUsage(_nMaxListsCacheMemoryUsage)
 {
+    nSnapshotListPeriod = std::max(1, (int)GetArg("-mnlistsnapshotperiod", DEFAULT_MNLIST_SNAPSHOT_PERIOD));
+    cacheStats.nMaxMemoryUsage = nMaxListsCacheMemoryUsage;
+    cacheStats.nSnapshotPeriod = nSnapshotListPeriod;
 }
 
 bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& _state, bool fJustCheck)
@@ -539,7 +573,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         diff = oldList.BuildDiff(newList);
 
         evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0 || oldList.GetHeight() == -1) {
+        if ((nHeight % nSnapshotListPeriod) == 0 || oldList.GetHeight() == -1) {
             evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
                 __func__, nHeight, newList.GetAllMNsCount());
@@ -561,9 +595,6 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         LogPrintf("CDeterministicMNManager::%s -- DIP3 is enforced now. nHeight=%d\n", __func__, nHeight);
     }
 
-    LOCK(cs);
-    CleanupCache(nHeight);
-
     return true;
 }
 
@@ -588,7 +619,7 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
         evoDb.Erase(std::make_pair(DB_LIST_DIFF, blockHash));
         evoDb.Erase(std::make_pair(DB_LIST_SNAPSHOT, blockHash));
 
-        mnListsCache.erase(blockHash);
+        EraseListFromCache(blockHash);
     }
 
     if (diff.HasChanges()) {
@@ -910,23 +941,24 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
     CDeterministicMNList snapshot;
     std::list<std::pair<const CBlockIndex*, CDeterministicMNListDiff>> listDiff;
 
+    bool fCached = false;
     while (true) {
         // try using cache before reading from disk
-        auto it = mnListsCache.find(pindex->GetBlockHash());
-        if (it != mnListsCache.end()) {
-            snapshot = it->second;
+        if (GetCachedList(pindex->GetBlockHash(), snapshot)) {
+            fCached = true;
             break;
         }
 
         if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            cacheStats.nSnapshotsRead++;
+            AddListToCache(snapshot);
             break;
         }
 
         CDeterministicMNListDiff diff;
         if (!evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
             snapshot = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            AddListToCache(snapshot);
             break;
         }
 
@@ -934,9 +966,19 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
         pindex = pindex->pprev;
     }
 
+    if (fCached && listDiff.empty()) {
+        cacheStats.nHits++;
+    } else {
+        cacheStats.nMisses++;
+    }
+    cacheStats.nDiffsApplied += listDiff.size();
+    cacheStats.nLastDiffDepth = (int)listDiff.size();
+    cacheStats.nMaxDiffDepth = std::max(cacheStats.nMaxDiffDepth, cacheStats.nLastDiffDepth);
+
     for (const auto& p : listDiff) {
         auto diffIndex = p.first;
         auto& diff = p.second;
+        uint256 baseBlockHash = snapshot.GetBlockHash();
         if (diff.HasChanges()) {
             snapshot = snapshot.ApplyDiff(diffIndex, diff);
         } else {
@@ -944,7 +986,7 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
             snapshot.SetHeight(diffIndex->nHeight);
         }
 
-        mnListsCache.emplace(diffIndex->GetBlockHash(), snapshot);
+        AddListToCache(snapshot, baseBlockHash, EstimateDiffMemoryUsage(snapshot, diff));
     }
 
     return snapshot;
@@ -995,19 +1037,88 @@ bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
     return nHeight >= Params().GetConsensus().DIP0003EnforcementHeight;
 }
 
-void CDeterministicMNManager::CleanupCache(int nHeight)
+CDeterministicMNListsCacheStats CDeterministicMNManager::GetCacheStats()
+{
+    LOCK(cs);
+
+    CDeterministicMNListsCacheStats stats = cacheStats;
+    stats.nEntries = mnListsCache.size();
+    return stats;
+}
+
+bool CDeterministicMNManager::GetCachedList(const uint256& blockHash, CDeterministicMNList& mnListRet)
+{
+    AssertLockHeld(cs);
+
+    auto it = mnListsCache.find(blockHash);
+    if (it == mnListsCache.end()) {
+        return false;
+    }
+    mnListsLru.splice(mnListsLru.end(), mnListsLru, it->second.lruIt);
+    mnListRet = it->second.mnList;
+    return true;
+}
+
+void CDeterministicMNManager::AddListToCache(const CDeterministicMNList& mnList, const uint256& baseBlockHash, size_t nDiffMemoryUsage)
+{
+    AssertLockHeld(cs);
+
+    const uint256& blockHash = mnList.GetBlockHash();
+    if (mnListsCache.count(blockHash)) {
+        return;
+    }
+
+    // nodes shared with a base list which is not cached are kept alive by this list alone
+    auto baseIt = baseBlockHash.IsNull() ? mnListsCache.end() : mnListsCache.find(baseBlockHash);
+    size_t nMemoryUsage = nDiffMemoryUsage;
+    if (baseIt != mnListsCache.end()) {
+        baseIt->second.derivedLists.emplace(blockHash);
+    } else {
+        nMemoryUsage = EstimateListMemoryUsage(mnList);
+    }
+
+    auto lruIt = mnListsLru.emplace(mnListsLru.end(), blockHash);
+    mnListsCache.emplace(blockHash, CachedList{mnList, nMemoryUsage, baseIt != mnListsCache.end() ? baseBlockHash : uint256(), {}, lruIt});
+    cacheStats.nMemoryUsage += nMemoryUsage;
+
+    // the list just added is kept even if it exceeds the limit alone
+    while (cacheStats.nMemoryUsage > nMaxListsCacheMemoryUsage && mnListsLru.size() > 1) {
+        EraseListFromCache(mnListsLru.front());
+        cacheStats.nEvictions++;
+    }
+}
+
+void CDeterministicMNManager::EraseListFromCache(const uint256& blockHash)
 {
     AssertLockHeld(cs);
 
-    std::vector<uint256> toDelete;
-    for (const auto& p : mnListsCache) {
-        if (p.second.GetHeight() + LISTS_CACHE_SIZE < nHeight) {
-            toDelete.emplace_back(p.first);
+    auto it = mnListsCache.find(blockHash);
+    if (it == mnListsCache.end()) {
+        return;
+    }
+
+    // lists derived from this one keep its nodes alive, they are charged their full size from now on
+    for (const auto& derivedBlockHash : it->second.derivedLists) {
+        auto derivedIt = mnListsCache.find(derivedBlockHash);
+        if (derivedIt == mnListsCache.end()) {
+            continue;
         }
+        cacheStats.nMemoryUsage -= derivedIt->second.nMemoryUsage;
+        derivedIt->second.nMemoryUsage = EstimateListMemoryUsage(derivedIt->second.mnList);
+        derivedIt->second.baseBlockHash.SetNull();
+        cacheStats.nMemoryUsage += derivedIt->second.nMemoryUsage;
     }
-    for (const auto& h : toDelete) {
-        mnListsCache.erase(h);
+
+    if (!it->second.baseBlockHash.IsNull()) {
+        auto baseIt = mnListsCache.find(it->second.baseBlockHash);
+        if (baseIt != mnListsCache.end()) {
+            baseIt->second.derivedLists.erase(blockHash);
+        }
     }
+
+    cacheStats.nMemoryUsage -= it->second.nMemoryUsage;
+    mnListsLru.erase(it->second.lruIt);
+    mnListsCache.erase(it);
 }
 
 bool CDeterministicMNManager::UpgradeDiff(CDBBatch& batch, const CBlockIndex* pindexNext, const CDeterministicMNList& curMNList, CDeterministicMNList& newMNList)
@@ -1101,7 +1212,7 @@ void CDeterministicMNManager::UpgradeDBIfNeeded()
         CDeterministicMNList newMNList;
         UpgradeDiff(batch, pindex, curMNList, newMNList);
 
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0) {
+        if ((nHeight % nSnapshotListPeriod) == 0) {
             batch.Write(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), newMNList);
             evoDb.GetRawDB().WriteBatch(batch);
             batch.Clear();
@@ -16,7 +16,9 @@
 #include "immer/map.hpp"
 #include "immer/map_transient.hpp"
 
+#include <list>
 #include <map>
+#include <set>
 
 class CBlock;
 class CBlockIndex;
@@ -623,22 +625,60 @@ public:
     }
 };
 
-class CDeterministicMNManager
+// Default number of blocks between znode list snapshots written to disk
+static const int DEFAULT_MNLIST_SNAPSHOT_PERIOD = 576; // once per day
+// Default limit of the memory used by cached znode lists, in MiB
+static const int64_t DEFAULT_MAX_MNLISTS_CACHE_SIZE = 64;
+
+struct CDeterministicMNListsCacheStats
 {
-    static const int SNAPSHOT_LIST_PERIOD = 576; // once per day
-    static const int LISTS_CACHE_SIZE = 576;
+    uint64_t nHits{0};
+    uint64_t nMisses{0};
+    uint64_t nSnapshotsRead{0};
+    uint64_t nDiffsApplied{0};
+    // number of diffs applied by the last and by the deepest lookup
+    int nLastDiffDepth{0};
+    int nMaxDiffDepth{0};
+    uint64_t nEvictions{0};
+    size_t nEntries{0};
+    size_t nMemoryUsage{0};
+    size_t nMaxMemoryUsage{0};
+    int nSnapshotPeriod{0};
+};
 
+class CDeterministicMNManager
+{
 public:
     CCriticalSection cs;
 
 private:
     CEvoDB& evoDb;
 
-    std::map<uint256, CDeterministicMNList> mnListsCache;
+    struct CachedList
+    {
+        CDeterministicMNList mnList;
+        // estimated memory not shared with the base list while it's cached, the full list size otherwise
+        size_t nMemoryUsage;
+        // cached list this one was derived from, null once it's charged its full size
+        uint256 baseBlockHash;
+        // cached lists derived from this one
+        std::set<uint256> derivedLists;
+        std::list<uint256>::iterator lruIt;
+    };
+
+    std::map<uint256, CachedList> mnListsCache;
+    // block hashes of cached lists, least recently used first
+    std::list<uint256> mnListsLru;
+    size_t nMaxListsCacheMemoryUsage;
+    int nSnapshotListPeriod;
+    CDeterministicMNListsCacheStats cacheStats;
+
     const CBlockIndex* tipIndex{nullptr};
 
 public:
     CDeterministicMNManager(CEvoDB& _evoDb);
+    // with the lists cache limited to nMaxListsCacheMemoryUsage bytes
+    CDeterministicMNManager(CEvoDB& _evoDb, size_t nMaxListsCacheMemoryUsage);
 
     bool ProcessBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state, bool fJustCheck);
     bool UndoBlock(const CBlock& block, const CBlockIndex* pindex);
@@ -653,6 +693,8 @@ public:
     CDeterministicMNList GetListForBlock(const CBlockIndex* pindex);
     CDeterministicMNList GetListAtChainTip();
 
+    CDeterministicMNListsCacheStats GetCacheStats();
+
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
 
@@ -665,7 +707,10 @@ public:
     static bool IsDIP3Active(int height);
 
 private:
-    void CleanupCache(int nHeight);
+    bool GetCachedList(const uint256& blockHash, CDeterministicMNList& mnListRet);
+    // a list derived from the cached base list is charged nDiffMemoryUsage while the base stays cached
+    void AddListToCache(const CDeterministicMNList& mnList, const uint256& baseBlockHash = uint256(), size_t nDiffMemoryUsage = 0);
+    void EraseListFromCache(const uint256& blockHash);
 };
 
 extern CDeterministicMNManager* deterministicMNManager;
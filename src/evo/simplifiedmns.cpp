@@ -88,6 +88,136 @@ uint256 CSimplifiedMNList::CalcMerkleRoot(bool* pmutated) const
     return ComputeMerkleRoot(leaves, pmutated);
 }
 
+void CSimplifiedMNListMerkleTree::Build(const CDeterministicMNList& dmnList)
+{
+    CSimplifiedMNList sml(dmnList);
+
+    proRegTxHashes.clear();
+    proRegTxHashes.reserve(sml.mnList.size());
+    levels.assign(1, std::vector<uint256>());
+    levels[0].reserve(sml.mnList.size());
+    for (const auto& e : sml.mnList) {
+        proRegTxHashes.emplace_back(e->proRegTxHash);
+        levels[0].emplace_back(e->CalcHash());
+    }
+    mutatedNodes.clear();
+
+    Recalc(0, {});
+}
+
+void CSimplifiedMNListMerkleTree::Update(const CDeterministicMNList& from, const CDeterministicMNList& to)
+{
+    if (levels.empty()) {
+        Build(to);
+        return;
+    }
+
+    auto diff = from.BuildDiff(to);
+
+    // positions from firstShifted on moved because of added or removed entries, other changed positions are in dirty
+    size_t firstShifted = proRegTxHashes.size();
+    std::set<size_t> dirty;
+
+    // removed ones are identified by their internalId in the old list, updated ones in the new list
+    for (const auto& id : diff.removedMns) {
+        auto dmn = from.GetMNByInternalId(id);
+        assert(dmn);
+        RemoveLeaf(dmn->proTxHash, firstShifted);
+    }
+    for (const auto& dmn : diff.addedMNs) {
+        SetLeaf(dmn->proTxHash, CSimplifiedMNListEntry(*dmn).CalcHash(), firstShifted, dirty);
+    }
+    for (const auto& p : diff.updatedMNs) {
+        auto dmn = to.GetMNByInternalId(p.first);
+        assert(dmn);
+        SetLeaf(dmn->proTxHash, CSimplifiedMNListEntry(*dmn).CalcHash(), firstShifted, dirty);
+    }
+
+    Recalc(firstShifted, std::move(dirty));
+}
+
+uint256 CSimplifiedMNListMerkleTree::GetMerkleRoot(bool* pmutated) const
+{
+    if (pmutated) {
+        *pmutated = !mutatedNodes.empty();
+    }
+    if (levels.empty() || levels.back().empty()) {
+        return uint256();
+    }
+    return levels.back()[0];
+}
+
+void CSimplifiedMNListMerkleTree::SetLeaf(const uint256& proRegTxHash, const uint256& hash, size_t& firstShifted, std::set<size_t>& dirty)
+{
+    auto it = std::lower_bound(proRegTxHashes.begin(), proRegTxHashes.end(), proRegTxHash);
+    size_t pos = it - proRegTxHashes.begin();
+    if (it != proRegTxHashes.end() && *it == proRegTxHash) {
+        if (levels[0][pos] != hash) {
+            levels[0][pos] = hash;
+            dirty.emplace(pos);
+        }
+        return;
+    }
+    proRegTxHashes.insert(it, proRegTxHash);
+    levels[0].insert(levels[0].begin() + pos, hash);
+    firstShifted = std::min(firstShifted, pos);
+}
+
+void CSimplifiedMNListMerkleTree::RemoveLeaf(const uint256& proRegTxHash, size_t& firstShifted)
+{
+    auto it = std::lower_bound(proRegTxHashes.begin(), proRegTxHashes.end(), proRegTxHash);
+    assert(it != proRegTxHashes.end() && *it == proRegTxHash);
+    size_t pos = it - proRegTxHashes.begin();
+    proRegTxHashes.erase(it);
+    levels[0].erase(levels[0].begin() + pos);
+    firstShifted = std::min(firstShifted, pos);
+}
+
+void CSimplifiedMNListMerkleTree::Recalc(size_t firstShifted, std::set<size_t> dirty)
+{
+    // same tree as ComputeMerkleRoot, the last node of a level with an odd size is hashed with itself
+    size_t level = 0;
+    while (levels[level].size() > 1) {
+        if (levels.size() == level + 1) {
+            levels.emplace_back();
+        }
+        const auto& children = levels[level];
+        auto& parents = levels[level + 1];
+        size_t size = (children.size() + 1) / 2;
+
+        // a level only grows or shrinks together with a shift of its tail, so the tail is recomputed anyway
+        parents.resize(size);
+        mutatedNodes.erase(mutatedNodes.lower_bound(std::make_pair(level + 1, size)), mutatedNodes.lower_bound(std::make_pair(level + 2, (size_t)0)));
+
+        std::set<size_t> parentsDirty;
+        for (size_t pos : dirty) {
+            parentsDirty.emplace(pos / 2);
+        }
+        for (size_t pos = firstShifted / 2; pos < size; pos++) {
+            parentsDirty.emplace(pos);
+        }
+
+        for (size_t pos : parentsDirty) {
+            const uint256& left = children[pos * 2];
+            const uint256& right = pos * 2 + 1 < children.size() ? children[pos * 2 + 1] : left;
+            parents[pos] = Hash(left.begin(), left.end(), right.begin(), right.end());
+            if (pos * 2 + 1 < children.size() && left == right) {
+                mutatedNodes.emplace(level + 1, pos);
+            } else {
+                mutatedNodes.erase(std::make_pair(level + 1, pos));
+            }
+        }
+
+        dirty = std::move(parentsDirty);
+        firstShifted /= 2;
+        level++;
+    }
+
+    // the tree got lower
+    levels.resize(level + 1);
+    mutatedNodes.erase(mutatedNodes.lower_bound(std::make_pair(level + 1, (size_t)0)), mutatedNodes.end());
+}
+
 CSimplifiedMNListDiff::CSimplifiedMNListDiff()
 {
 }
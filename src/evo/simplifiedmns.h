@@ -12,6 +12,8 @@
 #include "serialize.h"
 #include "version.h"
 
+#include <set>
+
 class UniValue;
 class CDeterministicMNList;
 class CDeterministicMN;
@@ -84,6 +86,35 @@ public:
     uint256 CalcMerkleRoot(bool* pmutated = NULL) const;
 };
 
+/**
+ * Merkle tree of the simplified list of a deterministic znode list, kept in memory between blocks. Updating it to
+ * another list only rehashes the entries of changed znodes and the inner nodes depending on them. Results in the same
+ * root as CSimplifiedMNList::CalcMerkleRoot.
+ */
+class CSimplifiedMNListMerkleTree
+{
+private:
+    // sorted like CSimplifiedMNList
+    std::vector<uint256> proRegTxHashes;
+    // levels[0] are the entry hashes, the last level holds the root
+    std::vector<std::vector<uint256>> levels;
+    // inner nodes (level, position) which were computed from two identical children
+    std::set<std::pair<size_t, size_t>> mutatedNodes;
+
+public:
+    void Build(const CDeterministicMNList& dmnList);
+    // from must be the list the tree was built or last updated with
+    void Update(const CDeterministicMNList& from, const CDeterministicMNList& to);
+
+    size_t GetSize() const { return proRegTxHashes.size(); }
+    uint256 GetMerkleRoot(bool* pmutated = nullptr) const;
+
+private:
+    void SetLeaf(const uint256& proRegTxHash, const uint256& hash, size_t& firstShifted, std::set<size_t>& dirty);
+    void RemoveLeaf(const uint256& proRegTxHash, size_t& firstShifted);
+    void Recalc(size_t firstShifted, std::set<size_t> dirty);
+};
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
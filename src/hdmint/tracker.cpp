@@ -29,6 +29,7 @@ CHDMintTracker::CHDMintTracker(std::string strWalletFile)
     this->strWalletFile = strWalletFile;
     mapSerialHashes.clear();
     mapLelantusSerialHashes.clear();
+    setSpendableLelantus.clear();
     mapPendingSpends.clear();
     fInitialized = false;
 }
@@ -44,6 +45,7 @@ CHDMintTracker::~CHDMintTracker()
 {
     mapSerialHashes.clear();
     mapLelantusSerialHashes.clear();
+    setSpendableLelantus.clear();
     mapPendingSpends.clear();
 }
 
@@ -93,8 +95,11 @@ bool CHDMintTracker::Archive(CLelantusMintMeta& meta)
 {
     uint256 hashPubcoin = meta.GetPubCoinValueHash();
 
-    if (HasLelantusSerialHash(meta.hashSerial))
-        mapLelantusSerialHashes.at(meta.hashSerial).isArchived = true;
+    if (HasLelantusSerialHash(meta.hashSerial)) {
+        CLelantusMintMeta archived = mapLelantusSerialHashes.at(meta.hashSerial);
+        archived.isArchived = true;
+        SetLelantusMeta(archived);
+    }
 
     CWalletDB walletdb(strWalletFile);
     CHDMint dMint;
@@ -252,6 +257,44 @@ bool CHDMintTracker::HasLelantusSerialHash(const uint256& hashSerial) const
     return it != mapLelantusSerialHashes.end();
 }
 
+bool CHDMintTracker::SpendableLelantusOrder::operator()(const SpendableLelantusKey& a, const SpendableLelantusKey& b) const
+{
+    if (std::get<0>(a) != std::get<0>(b))
+        return std::get<0>(a) > std::get<0>(b);
+    if (std::get<1>(a) != std::get<1>(b))
+        return std::get<1>(a) < std::get<1>(b);
+    return std::get<2>(a) < std::get<2>(b);
+}
+
+static bool IsSpendableLelantusMeta(const CLelantusMintMeta& meta)
+{
+    return !meta.isArchived && !meta.isUsed && meta.isSeedCorrect;
+}
+
+/**
+ * Store a Lelantus mint meta object in memory
+ *
+ * Every change of the in-memory Lelantus mints goes through here to keep the index of spendable mints current.
+ *
+ * @param meta the CLelantusMintMeta object to store
+ * @return void
+ */
+void CHDMintTracker::SetLelantusMeta(const CLelantusMintMeta& meta)
+{
+    auto it = mapLelantusSerialHashes.find(meta.hashSerial);
+    if (it != mapLelantusSerialHashes.end()) {
+        const CLelantusMintMeta& old = it->second;
+        if (IsSpendableLelantusMeta(old))
+            setSpendableLelantus.erase(std::make_tuple(CAmount(old.amount), old.nHeight, old.hashSerial));
+        it->second = meta;
+    } else {
+        mapLelantusSerialHashes.emplace(meta.hashSerial, meta);
+    }
+
+    if (IsSpendableLelantusMeta(meta))
+        setSpendableLelantus.emplace(CAmount(meta.amount), meta.nHeight, meta.hashSerial);
+}
+
 /**
  * Update the tracker state
  *
@@ -374,7 +417,7 @@ bool CHDMintTracker::UpdateState(const CLelantusMintMeta& meta)
             std::string("Update (") + std::to_string((double)dMint.GetAmount() / COIN) + "mint)",
             CT_UPDATED);
 
-    mapLelantusSerialHashes[meta.hashSerial] = meta;
+    SetLelantusMeta(meta);
 
     return true;
 }
@@ -430,7 +473,7 @@ void CHDMintTracker::AddLelantus(CWalletDB& walletdb, const CHDMint& dMint, bool
     meta.amount = dMint.GetAmount();
     meta.isArchived = isArchived;
     meta.isSeedCorrect = true;
-    mapLelantusSerialHashes[meta.hashSerial] = meta;
+    SetLelantusMeta(meta);
 
     pwalletMain->NotifyZerocoinChanged(
             pwalletMain,
@@ -557,7 +600,7 @@ bool CHDMintTracker::IsMempoolSpendOurs(const std::set<uint256>& setMempool, con
             }
 
             if (txin.IsLelantusJoinSplit()) {
-                std::unique_ptr<lelantus::JoinSplit> joinsplit;
+                std::shared_ptr<const lelantus::JoinSplit> joinsplit;
                 try {
                     joinsplit = lelantus::ParseLelantusJoinSplit(tx);
                 } catch (...) {
@@ -1269,6 +1312,36 @@ std::vector<CLelantusMintMeta> CHDMintTracker::ListLelantusMints(bool fUnusedOnl
     return setMints;
 }
 
+/**
+ * List spendable Lelantus mints from the in-memory index.
+ *
+ * Unlike ListLelantusMints this neither updates the mint status nor touches the database, the index is kept
+ * current by block and mempool updates going through UpdateState.
+ *
+ * @param fMatureOnly only list mints having enough confirmations to be spent
+ * @return mints ordered by biggest amount and then by oldest block
+ */
+std::vector<CLelantusMintMeta> CHDMintTracker::ListSpendableLelantusMints(bool fMatureOnly) const
+{
+    std::vector<CLelantusMintMeta> vMints;
+    vMints.reserve(setSpendableLelantus.size());
+
+    int nChainHeight = chainActive.Height();
+    for (const auto& key : setSpendableLelantus) {
+        const CLelantusMintMeta& mint = mapLelantusSerialHashes.at(std::get<2>(key));
+
+        if (fMatureOnly) {
+            // Not confirmed
+            if (!mint.nHeight || !(mint.nHeight + (ZC_MINT_CONFIRMATIONS-1) <= nChainHeight))
+                continue;
+        }
+
+        vMints.push_back(mint);
+    }
+
+    return vMints;
+}
+
 /**
  * Get txids of all mempool entries.
  *
@@ -9,6 +9,8 @@
 #include "hdmint/mintpool.h"
 #include "wallet/walletdb.h"
 #include <list>
+#include <set>
+#include <tuple>
 
 class CHDMint;
 class CHDMintWallet;
@@ -21,6 +23,17 @@ private:
     std::map<uint256, CMintMeta> mapSerialHashes;
     std::map<uint256, CLelantusMintMeta> mapLelantusSerialHashes;
     std::map<uint256, uint256> mapPendingSpends; //serialhash, txid of spend
+
+    // amount, height and serial hash of a lelantus mint, ordered by biggest amount and then by oldest block
+    typedef std::tuple<CAmount, int, uint256> SpendableLelantusKey;
+    struct SpendableLelantusOrder
+    {
+        bool operator()(const SpendableLelantusKey& a, const SpendableLelantusKey& b) const;
+    };
+    // unarchived and unused lelantus mints with correct seed, kept in sync with mapLelantusSerialHashes
+    std::set<SpendableLelantusKey, SpendableLelantusOrder> setSpendableLelantus;
+    void SetLelantusMeta(const CLelantusMintMeta& meta);
+
     bool IsMempoolSpendOurs(const std::set<uint256>& setMempool, const uint256& hashSerial);
     bool UpdateMetaStatus(const std::set<uint256>& setMempool, CMintMeta& mint, bool fSpend=false);
     bool UpdateLelantusMetaStatus(const std::set<uint256>& setMempool, CLelantusMintMeta& mint, bool fSpend=false);
@@ -59,6 +72,7 @@ public:
     std::list<CLelantusEntry> MintsAsLelantusEntries(bool fUnusedOnly = true, bool fMatureOnly = true);
     std::vector<CMintMeta> ListMints(bool fUnusedOnly = true, bool fMatureOnly = true, bool fUpdateStatus = true, bool fLoad = false, bool fWrongSeed = false);
     std::vector<CLelantusMintMeta> ListLelantusMints(bool fUnusedOnly = true, bool fMatureOnly = true, bool fUpdateStatus = true, bool fLoad = false, bool fWrongSeed = false);
+    std::vector<CLelantusMintMeta> ListSpendableLelantusMints(bool fMatureOnly = true) const;
     void SetPubcoinUsed(const uint256& hashPubcoin, const uint256& txid);
     void SetPubcoinNotUsed(const uint256& hashPubcoin);
     void SetLelantusPubcoinUsed(const uint256& hashPubcoin, const uint256& txid);
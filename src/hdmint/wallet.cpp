@@ -12,6 +12,7 @@
 #include "wallet/wallet.h"
 #include "sigma.h"
 #include "lelantus.h"
+#include "liblelantus/threadpool.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
 #include "keystore.h"
@@ -270,6 +271,8 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             listMints = std::list<std::pair<uint256, MintPoolEntry>>();
             mintPool.List(listMints.get());
         }
+        // lelantus mints found on chain by the hash of the transaction they were minted in
+        std::map<uint256, std::vector<std::pair<uint256, MintPoolEntry>>> lelantusMints;
         for (std::pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
             if (setChecked.count(pMint.first))
                 continue;
@@ -293,104 +296,9 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
 
             COutPoint outPoint;
             if (!pwalletMain->IsLocked() && lelantus::GetOutPointFromMintTag(outPoint, mintTag)) {
-                const uint256& txHash = outPoint.hash;
-                //this mint has already occurred on the chain, increment counter's state to reflect this
-                LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
-                found = true;
-
-                uint256 hashBlock;
-                CTransactionRef tx;
-                if (!GetTransaction(txHash, tx, Params().GetConsensus(), hashBlock, true)) {
-                    LogPrintf("%s : failed to get transaction for mint %s!\n", __func__, pMint.first.GetHex());
-                    found = false;
-                    continue;
-                }
-
-                uint64_t amount  = 0;
-                bool fFoundMint = false;
-                for (const CTxOut& out : tx->vout) {
-                    if (!out.scriptPubKey.IsLelantusMint() && !out.scriptPubKey.IsLelantusJMint())
-                        continue;
-                    secp_primitives::GroupElement pubcoin;
-                    try {
-                        if (out.scriptPubKey.IsLelantusMint()) {
-                            amount = out.nValue;
-                            lelantus::ParseLelantusMintScript(out.scriptPubKey, pubcoin);
-                        }  else {
-                            std::vector<unsigned char> encryptedValue;
-                            lelantus::ParseLelantusJMintScript(out.scriptPubKey, pubcoin, encryptedValue);
-                            if(!pwalletMain->DecryptMintAmount(encryptedValue, pubcoin, amount))
-                                continue;
-                        }
-                    } catch (std::invalid_argument&) {
-                        continue;
-                    }
-                    if(amount != 0)
-                        pubcoin += lelantus::Params::get_default()->get_h1() * Scalar(amount).negate();
-                    // See if this is the mint that we are looking for
-                    uint256 hashPubcoin = primitives::GetPubCoinValueHash(pubcoin);
-                    if (pMint.first == hashPubcoin) {
-                        fFoundMint = true;
-                        break;
-                    }
-                }
-
-                if (!fFoundMint) {
-                    LogPrintf("%s : failed to get mint %s from tx %s!\n", __func__, pMint.first.GetHex(), tx->GetHash().GetHex());
-                    found = false;
-                    break;
-                }
-
-                CBlockIndex* pindex = nullptr;
-                if (mapBlockIndex.count(hashBlock))
-                    pindex = mapBlockIndex.at(hashBlock);
-
-                if (!setAddedTx.count(txHash)) {
-                    CBlock block;
-                    CWalletTx wtx(pwalletMain, tx);
-                    if (pindex && ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-                        SetWalletTransactionBlock(wtx, pindex, block);
-
-                    //Fill out wtx so that a transaction record can be created
-                    wtx.nTimeReceived = pindex->GetBlockTime();
-                    pwalletMain->AddToWallet(wtx, false);
-                    setAddedTx.insert(txHash);
-                }
-
-                if(!SetLelantusMintSeedSeen(walletdb, pMint, pindex->nHeight, txHash, amount))
-                    continue;
-
-                if (tx->IsLelantusJoinSplit()) {
-                    std::vector<Scalar> serials = lelantus::GetLelantusJoinSplitSerialNumbers(*tx, tx->vin[0]);
-                    for (auto& serial : serials) {
-                        CLelantusMintMeta mMeta;
-                        if (!tracker.GetMetaFromSerial(primitives::GetSerialHash(serial), mMeta))
-                            continue;
-
-                        if (mMeta.isUsed)
-                            continue;
-
-                        tracker.SetLelantusPubcoinUsed(mMeta.GetPubCoinValueHash(), tx->GetHash());
-
-                        // add CLelantusSpendEntry
-                        CLelantusSpendEntry spend;
-                        spend.coinSerial = serial;
-                        spend.hashTx = tx->GetHash();
-                        spend.pubCoin = mMeta.GetPubCoinValue();
-                        spend.id = mMeta.nId;
-                        spend.amount = mMeta.amount;
-                        if (!walletdb.WriteLelantusSpendSerialEntry(spend)) {
-                            throw std::runtime_error(_("Failed to write coin serial number into wallet"));
-                        }
-                    }
-                }
-
-                // Only update if the current hashSeedMaster matches the mints'
-                if(hashSeedMaster == mintHashSeedMaster && mintCount >= GetCount()){
-                    SetCount(++mintCount);
-                    UpdateCountDB(walletdb);
-                    LogPrint("zero", "%s: updated count to %d\n", __func__, nCountNextUse);
-                }
+                //this mint has already occurred on the chain, it is restored together with the other mints of its block
+                LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, outPoint.hash.GetHex());
+                lelantusMints[outPoint.hash].emplace_back(pMint);
             } if (sigma::GetOutPoint(outPoint, pMint.first)) {
                 const uint256& txHash = outPoint.hash;
                 //this mint has already occurred on the chain, increment counter's state to reflect this
@@ -465,6 +373,16 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             if (found)
                 mintsFound++;
         }
+
+        if (!lelantusMints.empty()) {
+            size_t restored = SyncLelantusMints(walletdb, lelantusMints, setAddedTx);
+            if (ShutdownRequested())
+                return;
+            if (restored > 0) {
+                found = true;
+                mintsFound += restored;
+            }
+        }
         uiInterface.UpdateProgressBarLabel("");
         // Clear listMints to allow it to be repopulated by the mintPool on the next iteration
         if(found)
@@ -474,6 +392,177 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
     } while (found || mintsFound > 0);
 }
 
+/**
+ * Restore lelantus mints found on chain.
+ *
+ * Mint outputs of every transaction are parsed and decrypted once, pubcoins are normalized on the shared thread pool,
+ * and every block is read from disk once for all wallet transactions in it. The mint counter is written once at the end.
+ *
+ * @param txMints mint pool entries found on chain, by the hash of the transaction they were minted in
+ * @param setAddedTx transactions already added to the wallet
+ * @return number of mints restored
+ */
+size_t CHDMintWallet::SyncLelantusMints(CWalletDB& walletdb, const std::map<uint256, std::vector<std::pair<uint256, MintPoolEntry>>>& txMints, std::set<uint256>& setAddedTx)
+{
+    struct MintTx {
+        CTransactionRef tx;
+        // mint outputs as (pubcoin, amount), hashes of the normalized pubcoins
+        std::vector<std::pair<GroupElement, uint64_t>> outputs;
+        std::vector<uint256> pubcoinHashes;
+        const std::vector<std::pair<uint256, MintPoolEntry>>* mints;
+    };
+
+    // transactions ordered by the height of their block
+    std::map<std::pair<int, const CBlockIndex*>, std::vector<MintTx>> blockTxs;
+    for (const auto& p : txMints) {
+        uint256 hashBlock;
+        CTransactionRef tx;
+        if (!GetTransaction(p.first, tx, Params().GetConsensus(), hashBlock, true)) {
+            LogPrintf("%s : failed to get transaction %s!\n", __func__, p.first.GetHex());
+            continue;
+        }
+        auto mi = mapBlockIndex.find(hashBlock);
+        if (mi == mapBlockIndex.end()) {
+            LogPrintf("%s : failed to get block of transaction %s!\n", __func__, p.first.GetHex());
+            continue;
+        }
+
+        MintTx mintTx;
+        mintTx.tx = tx;
+        mintTx.mints = &p.second;
+        for (const CTxOut& out : tx->vout) {
+            if (!out.scriptPubKey.IsLelantusMint() && !out.scriptPubKey.IsLelantusJMint())
+                continue;
+            secp_primitives::GroupElement pubcoin;
+            uint64_t amount = 0;
+            try {
+                if (out.scriptPubKey.IsLelantusMint()) {
+                    amount = out.nValue;
+                    lelantus::ParseLelantusMintScript(out.scriptPubKey, pubcoin);
+                } else {
+                    std::vector<unsigned char> encryptedValue;
+                    lelantus::ParseLelantusJMintScript(out.scriptPubKey, pubcoin, encryptedValue);
+                    // needs the wallet keys, so it is not done on the thread pool
+                    if (!pwalletMain->DecryptMintAmount(encryptedValue, pubcoin, amount))
+                        continue;
+                }
+            } catch (std::invalid_argument&) {
+                continue;
+            }
+            mintTx.outputs.emplace_back(pubcoin, amount);
+        }
+        blockTxs[std::make_pair(mi->second->nHeight, mi->second)].emplace_back(std::move(mintTx));
+    }
+
+    std::vector<MintTx*> allTxs;
+    for (auto& p : blockTxs) {
+        for (auto& mintTx : p.second) {
+            mintTx.pubcoinHashes.resize(mintTx.outputs.size());
+            allTxs.emplace_back(&mintTx);
+        }
+    }
+
+    {
+        DoNotDisturb dnd;
+        GroupElement h1 = lelantus::Params::get_default()->get_h1();
+        ParallelForChunks(allTxs.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t j = 0; j < allTxs[i]->outputs.size(); ++j) {
+                    GroupElement pubcoin = allTxs[i]->outputs[j].first;
+                    uint64_t amount = allTxs[i]->outputs[j].second;
+                    if (amount != 0)
+                        pubcoin += h1 * Scalar(amount).negate();
+                    allTxs[i]->pubcoinHashes[j] = primitives::GetPubCoinValueHash(pubcoin);
+                }
+            }
+        });
+    }
+
+    size_t restored = 0;
+    bool fCountUpdated = false;
+    for (const auto& p : blockTxs) {
+        if (ShutdownRequested())
+            break;
+
+        const CBlockIndex* pindex = p.first.second;
+        CBlock block;
+        bool fBlockRead = false;
+
+        for (const MintTx& mintTx : p.second) {
+            const CTransactionRef& tx = mintTx.tx;
+            const uint256& txHash = tx->GetHash();
+
+            if (!setAddedTx.count(txHash)) {
+                if (!fBlockRead)
+                    fBlockRead = ReadBlockFromDisk(block, pindex, Params().GetConsensus());
+
+                CWalletTx wtx(pwalletMain, tx);
+                if (fBlockRead)
+                    SetWalletTransactionBlock(wtx, pindex, block);
+
+                //Fill out wtx so that a transaction record can be created
+                wtx.nTimeReceived = pindex->GetBlockTime();
+                pwalletMain->AddToWallet(wtx, false);
+                setAddedTx.insert(txHash);
+            }
+
+            for (const auto& pMint : *mintTx.mints) {
+                // See if this is the mint that we are looking for
+                auto it = std::find(mintTx.pubcoinHashes.begin(), mintTx.pubcoinHashes.end(), pMint.first);
+                if (it == mintTx.pubcoinHashes.end()) {
+                    LogPrintf("%s : failed to get mint %s from tx %s!\n", __func__, pMint.first.GetHex(), txHash.GetHex());
+                    continue;
+                }
+                uint64_t amount = mintTx.outputs[it - mintTx.pubcoinHashes.begin()].second;
+
+                if (!SetLelantusMintSeedSeen(walletdb, pMint, pindex->nHeight, txHash, amount))
+                    continue;
+                restored++;
+
+                // Only update if the current hashSeedMaster matches the mints'
+                const uint160& mintHashSeedMaster = std::get<0>(pMint.second);
+                int32_t mintCount = std::get<2>(pMint.second);
+                if (hashSeedMaster == mintHashSeedMaster && mintCount >= GetCount()) {
+                    SetCount(mintCount + 1);
+                    fCountUpdated = true;
+                }
+            }
+
+            if (tx->IsLelantusJoinSplit()) {
+                std::vector<Scalar> serials = lelantus::GetLelantusJoinSplitSerialNumbers(*tx, tx->vin[0]);
+                for (auto& serial : serials) {
+                    CLelantusMintMeta mMeta;
+                    if (!tracker.GetMetaFromSerial(primitives::GetSerialHash(serial), mMeta))
+                        continue;
+
+                    if (mMeta.isUsed)
+                        continue;
+
+                    tracker.SetLelantusPubcoinUsed(mMeta.GetPubCoinValueHash(), tx->GetHash());
+
+                    // add CLelantusSpendEntry
+                    CLelantusSpendEntry spend;
+                    spend.coinSerial = serial;
+                    spend.hashTx = tx->GetHash();
+                    spend.pubCoin = mMeta.GetPubCoinValue();
+                    spend.id = mMeta.nId;
+                    spend.amount = mMeta.amount;
+                    if (!walletdb.WriteLelantusSpendSerialEntry(spend)) {
+                        throw std::runtime_error(_("Failed to write coin serial number into wallet"));
+                    }
+                }
+            }
+        }
+    }
+
+    if (fCountUpdated) {
+        UpdateCountDB(walletdb);
+        LogPrint("zero", "%s: updated count to %d\n", __func__, nCountNextUse);
+    }
+
+    return restored;
+}
+
 /**
  * Add the mint from the chain to the mint tracker.
  *
@@ -49,6 +49,7 @@ public:
     void GenerateMintPool(CWalletDB& walletdb, bool forceGenerate = false, int32_t nIndex = 0);
     bool SetMintSeedSeen(CWalletDB& walletdb, std::pair<uint256,MintPoolEntry> mintPoolEntryPair, int nHeight, const uint256& txid, const sigma::CoinDenomination& denom);
     bool SetLelantusMintSeedSeen(CWalletDB& walletdb, std::pair<uint256,MintPoolEntry> mintPoolEntryPair, int nHeight, const uint256& txid, uint64_t amount);
+    size_t SyncLelantusMints(CWalletDB& walletdb, const std::map<uint256, std::vector<std::pair<uint256, MintPoolEntry>>>& txMints, std::set<uint256>& setAddedTx);
     bool SeedToMint(const uint512& mintSeed, GroupElement& bnValue, sigma::PrivateCoin& coin);
     bool SeedToLelantusMint(const uint512& mintSeed, lelantus::PrivateCoin& coin);
 
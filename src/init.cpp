@@ -30,6 +30,7 @@
 #include "rpc/register.h"
 #include "script/standard.h"
 #include "script/sigcache.h"
+#include "proofcache.h"
 #include "scheduler.h"
 #include "timedata.h"
 #include "txdb.h"
@@ -42,6 +43,7 @@
 #include "validation.h"
 #include "mtpstate.h"
 #include "batchproof_container.h"
+#include "liblelantus/threadpool.h"
 
 #ifdef ENABLE_WALLET
 #include "wallet/wallet.h"
@@ -256,6 +258,7 @@ void Shutdown()
     llmq::StopLLMQSystem();
 
     BatchProofContainer::get_instance()->finalize();
+    WorkStealingThreadPool::GetInstance().Stop();
 
 #ifdef ENABLE_WALLET
     if (pwalletMain)
@@ -287,6 +290,7 @@ void Shutdown()
         LOCK(cs_main);
         if (pcoinsTip != NULL) {
             FlushStateToDisk();
+            DumpPrivacyState();
         }
         delete pcoinsTip;
         pcoinsTip = NULL;
@@ -546,6 +550,9 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-limitfreerelay=<n>", strprintf("Continuously rate-limit free transactions to <n>*1000 bytes per minute (default: %u)", DEFAULT_LIMITFREERELAY));
         strUsage += HelpMessageOpt("-relaypriority", strprintf("Require high priority for relaying free or low-fee transactions (default: %u)", DEFAULT_RELAYPRIORITY));
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit size of signature cache to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxproofcachesize=<n>", strprintf("Limit size of verified lelantus proof cache to <n> MiB (default: %u)", DEFAULT_MAX_PROOF_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxmnlistscachesize=<n>", strprintf("Limit size of deterministic znode list cache to <n> MiB (default: %u)", DEFAULT_MAX_MNLISTS_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-mnlistsnapshotperiod=<n>", strprintf("Write a deterministic znode list snapshot to disk every <n> blocks (default: %u)", DEFAULT_MNLIST_SNAPSHOT_PERIOD));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in %s/kB) smaller than this are considered zero fee for relaying, mining and transaction creation (default: %s)"),
@@ -1482,6 +1489,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     LogPrintf("Using at most %i automatic connections (%i file descriptors available)\n", nMaxConnections, nFD);
 
     InitSignatureCache();
+    InitProofCache();
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
@@ -1489,6 +1497,9 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    // proof verification/creation pool is sized by -par as well, the waiting thread runs tasks too
+    WorkStealingThreadPool::GetInstance().SetNumberOfThreads(nScriptCheckThreads ? nScriptCheckThreads - 1 : 0);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1864,6 +1875,11 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         strLoadError = _("Unable to rewind the database to a pre-fork state. You will need to redownload the blockchain");
                         break;
                     }
+
+                    if (!RewindUnverifiedBatchBlocks(chainparams)) {
+                        strLoadError = _("Unable to roll back blocks with unverified batched proofs. You will need to rebuild the block database");
+                        break;
+                    }
                 }
 
                 uiInterface.InitMessage(_("Verifying blocks..."));
@@ -17,8 +17,12 @@
 #include "policy/policy.h"
 #include "coins.h"
 #include "batchproof_container.h"
+#include "proofcache.h"
+#include "saltedhasher.h"
+#include "memusage.h"
 
 #include <atomic>
+#include <list>
 #include <sstream>
 #include <chrono>
 
@@ -139,6 +143,31 @@ bool VerifyMintSchnorrProof(const uint64_t& v, const secp_primitives::GroupEleme
     return verifier.verify(comm, commit, (params->get_h1() * Scalar(v)), schnorrProof, challengeGenerator);
 }
 
+// Computes comm (G^s*H2^r) and the challenge of the mint Schnorr proof, which is then valid if u == comm^c * G^P1 * H2^T1,
+// used to check proofs of block mints in a single batch
+static void GetMintSchnorrProofStatement(
+        const uint64_t& v,
+        const secp_primitives::GroupElement& commit,
+        const SchnorrProof& schnorrProof,
+        bool afterFixes,
+        secp_primitives::GroupElement& comm,
+        Scalar& challenge)
+{
+    auto params = lelantus::Params::get_default();
+
+    GroupElement h1v = params->get_h1() * Scalar(v);
+    comm = commit + h1v.inverse();
+    SchnorrVerifier verifier(params->get_g(), params->get_h0(), afterFixes);
+    std::unique_ptr<ChallengeGenerator> challengeGenerator;
+    if (afterFixes) {
+        challengeGenerator = std::make_unique<ChallengeGeneratorImpl<CHash256>>(1);
+    }  else {
+        challengeGenerator = std::make_unique<ChallengeGeneratorImpl<CSHA256>>(0);
+    }
+
+    verifier.get_challenge(comm, commit, h1v, schnorrProof, challengeGenerator, challenge);
+}
+
 void ParseLelantusMintScript(const CScript& script, secp_primitives::GroupElement& pubcoin,  SchnorrProof& schnorrProof, uint256& mintTag)
 {
     if (script.size() < 1) {
@@ -209,12 +238,83 @@ void ParseLelantusMintScript(const CScript& script, secp_primitives::GroupElemen
     }
 }
 
-std::unique_ptr<JoinSplit> ParseLelantusJoinSplit(const CTransaction &tx)
+// Memory the parsed joinsplits cache may use, in bytes
+static const size_t MAX_PARSED_JOINSPLITS_MEMORY_USAGE = 32 << 20;
+// Group elements, which proofs are mostly made of, take 128 bytes in memory against 34 serialized
+static const size_t JOINSPLIT_MEMORY_USAGE_FACTOR = 4;
+
+/*
+ * Joinsplits with verified proofs by tx hash. A transaction is parsed on mempool acceptance, by the miner, on block
+ * connection and by the wallet, so every path shares a single immutable instance instead. Only verified joinsplits
+ * are added, invalid ones sent by peers never take space, and the cache is bounded by the estimated memory usage.
+ */
+class CParsedJoinSplitsCache
+{
+public:
+    bool Get(const uint256& txHash, std::shared_ptr<const JoinSplit>& joinsplit)
+    {
+        LOCK(cs);
+        auto it = entries.find(txHash);
+        if (it == entries.end())
+            return false;
+        lru.splice(lru.begin(), lru, it->second.lruIt);
+        joinsplit = it->second.joinsplit;
+        return true;
+    }
+
+    void Add(const uint256& txHash, const std::shared_ptr<const JoinSplit>& joinsplit, size_t nUsage)
+    {
+        if (nUsage > MAX_PARSED_JOINSPLITS_MEMORY_USAGE)
+            return;
+
+        LOCK(cs);
+        if (entries.count(txHash))
+            return;
+
+        while (nMemoryUsage + nUsage > MAX_PARSED_JOINSPLITS_MEMORY_USAGE) {
+            auto it = entries.find(lru.back());
+            nMemoryUsage -= it->second.nUsage;
+            entries.erase(it);
+            lru.pop_back();
+        }
+
+        lru.push_front(txHash);
+        entries.emplace(txHash, Entry{joinsplit, nUsage, lru.begin()});
+        nMemoryUsage += nUsage;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const JoinSplit> joinsplit;
+        size_t nUsage;
+        std::list<uint256>::iterator lruIt;
+    };
+
+    CCriticalSection cs;
+    // most recently used first
+    std::list<uint256> lru;
+    std::unordered_map<uint256, Entry, StaticSaltedHasher> entries;
+    size_t nMemoryUsage = 0;
+};
+
+static CParsedJoinSplitsCache parsedJoinSplits;
+
+static void AddVerifiedJoinSplit(const CTransaction &tx, const std::shared_ptr<const JoinSplit>& joinsplit)
+{
+    size_t nUsage = (tx.vin[0].scriptSig.size() + tx.vExtraPayload.size()) * JOINSPLIT_MEMORY_USAGE_FACTOR + sizeof(JoinSplit);
+    parsedJoinSplits.Add(tx.GetHash(), joinsplit, nUsage);
+}
+
+std::shared_ptr<const JoinSplit> ParseLelantusJoinSplit(const CTransaction &tx)
 {
     if (tx.vin.size() != 1 || tx.vin[0].scriptSig.size() < 1) {
         throw CBadTxIn();
     }
 
+    std::shared_ptr<const JoinSplit> joinsplit;
+    if (parsedJoinSplits.Get(tx.GetHash(), joinsplit))
+        return joinsplit;
+
     CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
 
     if (tx.vin[0].scriptSig[0] == OP_LELANTUSJOINSPLIT) {
@@ -226,7 +326,8 @@ std::unique_ptr<JoinSplit> ParseLelantusJoinSplit(const CTransaction &tx)
     else
         throw CBadTxIn();
 
-    return std::make_unique<lelantus::JoinSplit>(lelantus::Params::get_default(), serialized);
+    // cached only once CheckLelantusJoinSplitTransaction has verified the proof
+    return std::make_shared<const lelantus::JoinSplit>(lelantus::Params::get_default(), serialized);
 }
 
 bool CheckLelantusBlock(CValidationState &state, const CBlock& block) {
@@ -373,7 +474,8 @@ bool CheckLelantusJoinSplitTransaction(
         }
     }
     const CTxIn &txin = tx.vin[0];
-    std::unique_ptr<lelantus::JoinSplit> joinsplit;
+    // shared with the verification task if the proof is verified in parallel
+    std::shared_ptr<const lelantus::JoinSplit> joinsplit;
 
     try {
         joinsplit = ParseLelantusJoinSplit(tx);
@@ -436,15 +538,25 @@ bool CheckLelantusJoinSplitTransaction(
     }
 
     std::vector<std::vector<unsigned char>> anonymity_set_hashes;
+    // last and first block of every anonymity set
+    std::map<uint32_t, std::pair<CBlockIndex*, CBlockIndex*>> anonymity_set_blocks;
+    // skip mints from blacklist if nLelantusFixesStartBlock is passed
+    bool fSkipLelantusBlacklisted = chainActive.Height() >= params.nLelantusFixesStartBlock;
+
+    // the proof is verified against the exact anonymity sets found here, bind cached result to them
+    CProofCacheEntry proofCacheEntry(hashTx);
+    proofCacheEntry.AddFlag(nHeight >= params.nLelantusFixesStartBlock);
 
     for (auto& idAndHash : joinsplit->getIdAndBlockHashes()) {
-        auto& anonymity_set = anonymity_sets[idAndHash.first];
         int coinGroupId = idAndHash.first % (CENT / 1000);
         int64_t intDenom = (idAndHash.first - coinGroupId);
         intDenom *= 1000;
 
+        CBlockIndex *index, *firstBlock;
+        bool fSkipBlacklisted;
         sigma::CoinDenomination denomination;
-        if (joinsplit->isSigmaToLelantus() && sigma::IntegerToDenomination(intDenom, denomination)) {
+        bool fSigmaSet = joinsplit->isSigmaToLelantus() && sigma::IntegerToDenomination(intDenom, denomination);
+        if (fSigmaSet) {
 
             sigma::CSigmaState::SigmaCoinGroupInfo coinGroup;
             sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
@@ -452,92 +564,127 @@ bool CheckLelantusJoinSplitTransaction(
                 return state.DoS(100, false, NO_MINT_ZEROCOIN,
                                  "CheckSigmaSpendTransaction: Error: no coins were minted with such parameters");
 
-            CBlockIndex *index = coinGroup.lastBlock;
-
-            // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
-            while (index != coinGroup.firstBlock && index->GetBlockHash() != idAndHash.second)
-                index = index->pprev;
-
-            std::pair<sigma::CoinDenomination, int> denominationAndId = std::make_pair(denomination, coinGroupId);
-
-            auto lelantusParams = lelantus::Params::get_default();
-            while (true) {
-                if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
-                    BOOST_FOREACH(
-                    const sigma::PublicCoin &pubCoinValue,
-                    index->sigmaMintedPubCoins[denominationAndId]) {
-                        if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
-                            continue;
-                        }
-                        lelantus::PublicCoin publicCoin(pubCoinValue.getValue() + lelantusParams->get_h1() * intDenom);
-                        anonymity_set.push_back(publicCoin);
-                    }
-                }
-                if (index == coinGroup.firstBlock)
-                    break;
-                index = index->pprev;
-            }
+            index = coinGroup.lastBlock;
+            firstBlock = coinGroup.firstBlock;
+            fSkipBlacklisted = true;
         } else {
             CLelantusState::LelantusCoinGroupInfo coinGroup;
             if (!lelantusState.GetCoinGroupInfo(idAndHash.first, coinGroup))
                 return state.DoS(100, false, NO_MINT_ZEROCOIN,
                                  "CheckLelantusJoinSplitTransaction: Error: no coins were minted with such parameters");
 
-            CBlockIndex *index = coinGroup.lastBlock;
+            index = coinGroup.lastBlock;
+            firstBlock = coinGroup.firstBlock;
+            fSkipBlacklisted = fSkipLelantusBlacklisted;
+        }
 
+        // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
+        while (index != firstBlock && index->GetBlockHash() != idAndHash.second)
+            index = index->pprev;
 
-            // find index for block with hash of accumulatorBlockHash or set index to the coinGroup.firstBlock if not found
-            while (index != coinGroup.firstBlock && index->GetBlockHash() != idAndHash.second)
-                index = index->pprev;
+        // take the hash from last block of anonymity set, it is used at challenge generation if nLelantusFixesStartBlock is passed
+        if (!fSigmaSet && nHeight >= params.nLelantusFixesStartBlock) {
+            std::vector<unsigned char> set_hash = GetAnonymitySetHash(index, idAndHash.first);
+            if (!set_hash.empty())
+                anonymity_set_hashes.push_back(set_hash);
+        }
 
-            // take the hash from last block of anonymity set, it is used at challenge generation if nLelantusFixesStartBlock is passed
-            if (nHeight >= params.nLelantusFixesStartBlock) {
-                std::vector<unsigned char> set_hash = GetAnonymitySetHash(index, idAndHash.first);
-                if (!set_hash.empty())
-                    anonymity_set_hashes.push_back(set_hash);
-            }
-            // Build a vector with all the public coins with given id before
-            // the block on which the spend occured.
-            // This list of public coins is required by function "Verify" of JoinSplit.
-
-            while (true) {
-                if(index->lelantusMintedPubCoins.count(idAndHash.first) > 0) {
-                    BOOST_FOREACH(
-                    const auto& pubCoinValue,
-                    index->lelantusMintedPubCoins[idAndHash.first]) {
-                        // skip mints from blacklist if nLelantusFixesStartBlock is passed
-                        if (chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock) {
-                            if (::Params().GetConsensus().lelantusBlacklist.count(pubCoinValue.first.getValue()) > 0) {
-                                continue;
+        anonymity_set_blocks[idAndHash.first] = std::make_pair(index, firstBlock);
+        proofCacheEntry.AddAnonymitySet(idAndHash.first, firstBlock, index, fSkipBlacklisted);
+    }
+
+    // proofs of mempool transactions are cached to skip their verification when the block is connected,
+    // checking a block template must not consume them
+    bool fMempoolCheck = nHeight == INT_MAX;
+    uint256 proofCacheHash = proofCacheEntry.GetHash();
+    BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
+    bool fProofCached = IsProofCached(proofCacheHash, !fMempoolCheck && !batchProofContainer->fCacheResults);
+
+    bool useBatching = !fProofCached && batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete;
+
+    if (fProofCached) {
+        passVerify = true;
+    } else {
+        for (const auto& idAndBlocks : anonymity_set_blocks) {
+            auto& anonymity_set = anonymity_sets[idAndBlocks.first];
+            int coinGroupId = idAndBlocks.first % (CENT / 1000);
+            int64_t intDenom = (idAndBlocks.first - coinGroupId);
+            intDenom *= 1000;
+
+            CBlockIndex *index = idAndBlocks.second.first;
+            CBlockIndex *firstBlock = idAndBlocks.second.second;
+
+            sigma::CoinDenomination denomination;
+            if (joinsplit->isSigmaToLelantus() && sigma::IntegerToDenomination(intDenom, denomination)) {
+                // coins with denomination added are taken from the cache, it saves a multiplication per coin
+                CAnonymitySetCache& anonymitySetCache = lelantusState.GetAnonymitySetCache();
+                while (true) {
+                    auto coins = anonymitySetCache.GetSigmaCoins(index, denomination, coinGroupId, true);
+                    anonymity_set.insert(anonymity_set.end(), coins->begin(), coins->end());
+                    if (index == firstBlock)
+                        break;
+                    index = index->pprev;
+                }
+            } else {
+                // Build a vector with all the public coins with given id before
+                // the block on which the spend occured.
+                // This list of public coins is required by function "Verify" of JoinSplit.
+
+                while (true) {
+                    LoadPrivacyPayload(index);
+                    if(index->lelantusMintedPubCoins.count(idAndBlocks.first) > 0) {
+                        BOOST_FOREACH(
+                        const auto& pubCoinValue,
+                        index->lelantusMintedPubCoins[idAndBlocks.first]) {
+                            if (fSkipLelantusBlacklisted) {
+                                if (::Params().GetConsensus().lelantusBlacklist.count(pubCoinValue.first.getValue()) > 0) {
+                                    continue;
+                                }
                             }
+                            anonymity_set.push_back(pubCoinValue.first);
                         }
-                        anonymity_set.push_back(pubCoinValue.first);
                     }
+                    if (index == firstBlock)
+                        break;
+                    index = index->pprev;
                 }
-                if (index == coinGroup.firstBlock)
-                    break;
-                index = index->pprev;
             }
         }
-        anonymity_sets[idAndHash.first] = anonymity_set;
-    }
 
-    BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-    bool useBatching = batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete;
-
-    Scalar challenge;
-    // if we are collecting proofs, skip verification and collect proofs
-    passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge, useBatching);
+        // proofs of the block being connected are verified on the thread pool, while serials
+        // are checked here in the order of transactions
+        bool fParallelCheck = !useBatching && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete
+                && batchProofContainer->isConnectingBlock();
+
+        Scalar challenge;
+        if (fParallelCheck) {
+            auto sets = std::make_shared<std::map<uint32_t, std::vector<PublicCoin>>>(std::move(anonymity_sets));
+            batchProofContainer->verifyInParallel([joinsplit, sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, hashTx]() {
+                if (!joinsplit->Verify(*sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata)) {
+                    LogPrintf("CheckLelantusJoinSplitTransaction: verification failed, tx=%s\n", hashTx.ToString());
+                    return false;
+                }
+                return true;
+            });
+            passVerify = true;
+        } else {
+            // if we are collecting proofs, skip verification and collect proofs
+            passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge, useBatching);
+        }
 
-    // add proofs into container
-    if(useBatching) {
-        std::map<uint32_t, size_t> idAndSizes;
+        // add proofs into container
+        if(useBatching) {
+            std::map<uint32_t, size_t> idAndSizes;
 
-        for(auto itr : anonymity_sets)
-            idAndSizes[itr.first] = itr.second.size();
+            for(auto itr : anonymity_sets)
+                idAndSizes[itr.first] = itr.second.size();
 
-        batchProofContainer->add(joinsplit.get(), idAndSizes, challenge, nHeight >= params.nLelantusFixesStartBlock);
-        batchProofContainer->add(joinsplit.get(), Cout);
+            batchProofContainer->add(joinsplit.get(), idAndSizes, challenge, nHeight >= params.nLelantusFixesStartBlock);
+            batchProofContainer->add(joinsplit.get(), Cout);
+        } else if (passVerify && fMempoolCheck) {
+            AddProofToCache(proofCacheHash);
+            AddVerifiedJoinSplit(tx, joinsplit);
+        }
     }
 
     if (passVerify) {
@@ -655,7 +802,24 @@ bool CheckLelantusMintTransaction(
     lelantus::PublicCoin pubCoin(pubCoinValue);
 
     //checking whether commitment is valid
-    if(!VerifyMintSchnorrProof(txout.nValue, pubCoinValue, schnorrProof) || !pubCoin.validate())
+    bool fProofValid;
+    if (lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete && fStatefulSigmaCheck && BatchProofContainer::get_instance()->isConnectingBlock()) {
+        // block is being connected, Schnorr proofs of all its mints are checked together in ConnectBlock
+        bool afterFixes;
+        {
+            LOCK(cs_main);
+            afterFixes = chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock;
+        }
+        secp_primitives::GroupElement comm;
+        Scalar challenge;
+        GetMintSchnorrProofStatement(txout.nValue, pubCoinValue, schnorrProof, afterFixes, comm, challenge);
+        BatchProofContainer::get_instance()->add(comm, challenge, schnorrProof);
+        fProofValid = true;
+    } else {
+        fProofValid = VerifyMintSchnorrProof(txout.nValue, pubCoinValue, schnorrProof);
+    }
+
+    if(!fProofValid || !pubCoin.validate())
         return state.DoS(100,
                          false,
                          PUBCOIN_NOT_VALIDATE,
@@ -768,7 +932,7 @@ void RemoveLelantusJoinSplitReferencingBlock(CTxMemPool& pool, CBlockIndex* bloc
             // block removed. If any one is equal, remove txn from mempool.
             for (const CTxIn& txin : tx.vin) {
                 if (txin.IsLelantusJoinSplit()) {
-                    std::unique_ptr<lelantus::JoinSplit> joinsplit;
+                    std::shared_ptr<const lelantus::JoinSplit> joinsplit;
 
                     try {
                         joinsplit = ParseLelantusJoinSplit(tx);
@@ -1018,8 +1182,9 @@ bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
-bool BuildLelantusStateFromIndex(CChain *chain) {
-    for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
+bool BuildLelantusStateFromIndex(CChain *chain, const CBlockIndex *pindexFrom) {
+    CBlockIndex *blockIndex = pindexFrom ? chain->Next(pindexFrom) : chain->Genesis();
+    for (; blockIndex; blockIndex=chain->Next(blockIndex))
     {
         lelantusState.AddBlock(blockIndex);
     }
@@ -1050,6 +1215,11 @@ void CLelantusTxInfo::Complete() {
  * Util funtions
  */
 size_t CountCoinInBlock(CBlockIndex *index, int id) {
+    // the summary saves reading the payload of blocks without coins of this group
+    if (!index->fPrivacyPayloadLoaded && index->nLelantusMintsGroupId >= 0)
+        return index->nLelantusMintsGroupId == id ? index->nLelantusMints : 0;
+
+    LoadPrivacyPayload(index);
     return index->lelantusMintedPubCoins.count(id) > 0
         ? index->lelantusMintedPubCoins[id].size() : 0;
 }
@@ -1138,6 +1308,52 @@ void CLelantusState::Containers::Reset() {
     surgeCondition = false;
 }
 
+void CLelantusState::Containers::Dump(CAutoFile& file) const {
+    WriteCompactSize(file, mintedPubCoins.size());
+    for (const auto& mint : mintedPubCoins) {
+        file << mint.first << mint.second.coinGroupId << mint.second.nHeight;
+    }
+    file << usedCoinSerials;
+    file << tagToPublicCoin;
+
+    for (const metainfo_container_t* metaInfo : {&extendedMintMetaInfo, &mintMetaInfo, &spendMetaInfo}) {
+        WriteCompactSize(file, metaInfo->size());
+        for (const auto& group : *metaInfo)
+            file << group.first << (uint64_t)group.second;
+    }
+    file << (bool)surgeCondition;
+}
+
+void CLelantusState::Containers::Load(CAutoFile& file) {
+    Reset();
+    extendedMintMetaInfo.clear();
+
+    uint64_t nMints = ReadCompactSize(file);
+    mintedPubCoins.reserve(nMints);
+    for (uint64_t i = 0; i < nMints; i++) {
+        lelantus::PublicCoin pubCoin;
+        CMintedCoinInfo coinInfo;
+        file >> pubCoin >> coinInfo.coinGroupId >> coinInfo.nHeight;
+        mintedPubCoins.emplace(pubCoin, coinInfo);
+    }
+    file >> usedCoinSerials;
+    file >> tagToPublicCoin;
+
+    for (metainfo_container_t* metaInfo : {&extendedMintMetaInfo, &mintMetaInfo, &spendMetaInfo}) {
+        uint64_t nGroups = ReadCompactSize(file);
+        for (uint64_t i = 0; i < nGroups; i++) {
+            int groupId;
+            uint64_t count;
+            file >> groupId >> count;
+            (*metaInfo)[groupId] = count;
+        }
+    }
+
+    bool fSurgeCondition;
+    file >> fSurgeCondition;
+    surgeCondition = fSurgeCondition;
+}
+
 void CLelantusState::Containers::CheckSurgeCondition() {
     bool result = false;
 
@@ -1238,6 +1454,8 @@ void CLelantusState::AddMintsToStateAndBlockIndex(
         LogPrintf("AddMintsToStateAndBlockIndex: Lelantus mint added id=%d\n", latestCoinId);
         index->lelantusMintedPubCoins[latestCoinId].push_back(mint);
     }
+
+    anonymitySetCache.AddBlock(index);
 }
 
 void CLelantusState::AddSpend(const Scalar &serial, int coinGroupId) {
@@ -1245,6 +1463,8 @@ void CLelantusState::AddSpend(const Scalar &serial, int coinGroupId) {
 }
 
 void CLelantusState::AddBlock(CBlockIndex *index) {
+    LoadPrivacyPayload(index);
+
     for (auto const &pubCoins : index->lelantusMintedPubCoins) {
 
         if (pubCoins.second.empty())
@@ -1278,6 +1498,8 @@ void CLelantusState::AddBlock(CBlockIndex *index) {
 }
 
 void CLelantusState::RemoveBlock(CBlockIndex *index) {
+    LoadPrivacyPayload(index);
+
     // roll back coin group updates
     for (auto &coins : index->lelantusMintedPubCoins)
     {
@@ -1325,7 +1547,7 @@ void CLelantusState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
-            } while (coinGroup.lastBlock->lelantusMintedPubCoins.count(coins.first) == 0);
+            } while (CountCoinInBlock(coinGroup.lastBlock, coins.first) == 0);
         }
     }
 
@@ -1347,6 +1569,8 @@ void CLelantusState::RemoveBlock(CBlockIndex *index) {
     for (auto const &serial : index->lelantusSpentSerials) {
         containers.RemoveSpend(serial.first);
     }
+
+    anonymitySetCache.RemoveBlock(index);
 }
 
 bool CLelantusState::GetCoinGroupInfo(
@@ -1405,21 +1629,80 @@ int CLelantusState::GetCoinSetForSpend(
     std::vector<lelantus::PublicCoin>& coins_out,
     std::vector<unsigned char>& setHash_out) {
 
-    coins_out.clear();
+    std::shared_ptr<const CoinSetForSpend> coinSet = GetCoinSetSnapshotForSpend(chain, maxHeight, coinGroupID);
+
+    coins_out = coinSet->coins;
+    if (!coinSet->blockHash.IsNull()) {
+        blockHash_out = coinSet->blockHash;
+        setHash_out = coinSet->setHash;
+    }
+
+    return coinSet->nCoins;
+}
+
+std::shared_ptr<const CLelantusState::CoinSetForSpend> CLelantusState::GetCoinSetSnapshotForSpend(
+    CChain *chain,
+    int maxHeight,
+    int coinGroupID) {
+
+    static const std::shared_ptr<const CoinSetForSpend> emptySet = std::make_shared<CoinSetForSpend>();
 
     if (coinGroups.count(coinGroupID) == 0) {
-        return 0;
+        return emptySet;
     }
 
     LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
 
-    int numberOfCoins = 0;
+    bool fSkipBlacklisted;
+    {
+        LOCK(cs_main);
+        // skip mints from blacklist if nLelantusFixesStartBlock is passed
+        fSkipBlacklisted = chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock;
+    }
+
+    // latest block having coins of the set, blocks below it stay the same as long as it is in the chain
+    CBlockIndex *head = nullptr;
     for (CBlockIndex *block = coinGroup.lastBlock;; block = block->pprev) {
+        if (block->nHeight <= maxHeight
+            && (CountCoinInBlock(block, coinGroupID) || CountCoinInBlock(block, coinGroupID - 1))) {
+            head = block;
+            break;
+        }
 
-        // ignore block heigher than max height
-        if (block->nHeight > maxHeight) {
-            continue;
+        if (block == coinGroup.firstBlock) {
+            break;
         }
+    }
+
+    if (!head) {
+        return emptySet;
+    }
+
+    LOCK(cs_coinSetSnapshots);
+    auto it = coinSetSnapshots.find(coinGroupID);
+    if (it != coinSetSnapshots.end() && it->second.head == head && it->second.fSkipBlacklisted == fSkipBlacklisted) {
+        return it->second.coinSet;
+    }
+
+    CoinSetSnapshot snapshot;
+    snapshot.head = head;
+    snapshot.fSkipBlacklisted = fSkipBlacklisted;
+    snapshot.coinSet = BuildCoinSetForSpend(head, coinGroupID, fSkipBlacklisted);
+    coinSetSnapshots[coinGroupID] = snapshot;
+
+    return snapshot.coinSet;
+}
+
+std::shared_ptr<const CLelantusState::CoinSetForSpend> CLelantusState::BuildCoinSetForSpend(
+    CBlockIndex *head,
+    int coinGroupID,
+    bool fSkipBlacklisted) {
+
+    std::shared_ptr<CoinSetForSpend> coinSet = std::make_shared<CoinSetForSpend>();
+    LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
+    const auto &blacklist = ::Params().GetConsensus().lelantusBlacklist;
+
+    for (CBlockIndex *block = head;; block = block->pprev) {
 
         // check coins in group coinGroupID - 1 in the case that using coins from prev group.
         int id = 0;
@@ -1430,23 +1713,21 @@ int CLelantusState::GetCoinSetForSpend(
         }
 
         if (id) {
-            if (numberOfCoins == 0) {
+            if (coinSet->nCoins == 0) {
                 // latest block satisfying given conditions
                 // remember block hash and set hash
-                blockHash_out = block->GetBlockHash();
-                setHash_out =  GetAnonymitySetHash(block, id);
+                coinSet->blockHash = block->GetBlockHash();
+                coinSet->setHash = GetAnonymitySetHash(block, id);
             }
-            numberOfCoins += block->lelantusMintedPubCoins[id].size();
-            if (block->lelantusMintedPubCoins.count(id) > 0) {
-                for (const auto &coin : block->lelantusMintedPubCoins[id]) {
-                    LOCK(cs_main);
-                    // skip mints from blacklist if nLelantusFixesStartBlock is passed
-                    if (chainActive.Height() >= ::Params().GetConsensus().nLelantusFixesStartBlock) {
-                        if (::Params().GetConsensus().lelantusBlacklist.count(coin.first.getValue()) > 0) {
-                            continue;
-                        }
+            LoadPrivacyPayload(block);
+            auto mintedIt = block->lelantusMintedPubCoins.find(id);
+            if (mintedIt != block->lelantusMintedPubCoins.end()) {
+                coinSet->nCoins += mintedIt->second.size();
+                for (const auto &coin : mintedIt->second) {
+                    if (fSkipBlacklisted && blacklist.count(coin.first.getValue()) > 0) {
+                        continue;
                     }
-                    coins_out.push_back(coin.first);
+                    coinSet->coins.push_back(coin.first);
                 }
             }
         }
@@ -1456,7 +1737,7 @@ int CLelantusState::GetCoinSetForSpend(
         }
     }
 
-    return numberOfCoins;
+    return coinSet;
 }
 
 void CLelantusState::GetAnonymitySet(
@@ -1491,6 +1772,7 @@ void CLelantusState::GetAnonymitySet(
         }
 
         if (id) {
+            LoadPrivacyPayload(block);
             if(block->lelantusMintedPubCoins.count(id) > 0) {
                 for (const auto &coin : block->lelantusMintedPubCoins[id]) {
                     if (fStartLelantusBlacklist &&
@@ -1511,6 +1793,242 @@ void CLelantusState::GetAnonymitySet(
     }
 }
 
+void CLelantusState::GetAnonymitySet(
+        int coinGroupID,
+        bool fStartLelantusBlacklist,
+        std::vector<GroupElement>& coins_out) {
+
+    coins_out.clear();
+
+    if (coinGroups.count(coinGroupID) == 0) {
+        return;
+    }
+
+    LelantusCoinGroupInfo &coinGroup = coinGroups[coinGroupID];
+    const auto &params = ::Params().GetConsensus();
+    LOCK(cs_main);
+    int maxHeight = fStartLelantusBlacklist ? (chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1)) : (params.nLelantusFixesStartBlock - 1);
+    bool fSkipBlacklisted = fStartLelantusBlacklist && chainActive.Height() >= params.nLelantusFixesStartBlock;
+
+    coins_out.reserve(coinGroup.nCoins);
+    for (CBlockIndex *block = coinGroup.lastBlock;; block = block->pprev) {
+
+        // ignore block heigher than max height
+        if (block->nHeight > maxHeight) {
+            continue;
+        }
+
+        // check coins in group coinGroupID - 1 in the case that using coins from prev group.
+        int id = 0;
+        if (CountCoinInBlock(block, coinGroupID)) {
+            id = coinGroupID;
+        } else if (CountCoinInBlock(block, coinGroupID - 1)) {
+            id = coinGroupID - 1;
+        }
+
+        if (id) {
+            auto coins = anonymitySetCache.GetLelantusCoins(block, id, fSkipBlacklisted);
+            coins_out.insert(coins_out.end(), coins->begin(), coins->end());
+        }
+
+        if (block == coinGroup.firstBlock) {
+            break ;
+        }
+    }
+}
+
+void CLelantusState::GetSigmaToLelantusAnonymitySet(
+        sigma::CoinDenomination denomination,
+        int coinGroupID,
+        bool fStartSigmaBlacklist,
+        std::vector<GroupElement>& coins_out) {
+
+    coins_out.clear();
+
+    sigma::CSigmaState::SigmaCoinGroupInfo coinGroup;
+    if (!sigma::CSigmaState::GetState()->GetCoinGroupInfo(denomination, coinGroupID, coinGroup))
+        return;
+
+    const auto &params = ::Params().GetConsensus();
+    LOCK(cs_main);
+    int maxHeight = fStartSigmaBlacklist ? (chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1)) : (params.nStartSigmaBlacklist - 1);
+    bool fSkipBlacklisted = fStartSigmaBlacklist && chainActive.Height() >= params.nStartSigmaBlacklist;
+
+    coins_out.reserve(coinGroup.nCoins);
+    for (CBlockIndex *block = coinGroup.lastBlock;; block = block->pprev) {
+        if (block->nHeight <= maxHeight) {
+            auto coins = anonymitySetCache.GetSigmaCoins(block, denomination, coinGroupID, fSkipBlacklisted);
+            coins_out.insert(coins_out.end(), coins->begin(), coins->end());
+        }
+
+        if (block == coinGroup.firstBlock) {
+            break ;
+        }
+    }
+}
+
+CAnonymitySetCache::BlockCoins CAnonymitySetCache::GetLelantusCoins(CBlockIndex *index, int coinGroupId, bool fSkipBlacklisted) {
+    return Get(index, SetKey(coinGroupId, false, fSkipBlacklisted));
+}
+
+CAnonymitySetCache::BlockCoins CAnonymitySetCache::GetSigmaCoins(
+        CBlockIndex *index,
+        sigma::CoinDenomination denomination,
+        int coinGroupId,
+        bool fSkipBlacklisted) {
+    int64_t intDenom;
+    if (!sigma::DenominationToInteger(denomination, intDenom))
+        throw std::invalid_argument("CAnonymitySetCache: invalid denomination");
+
+    // the same id as used in joinsplits
+    return Get(index, SetKey(intDenom / 1000 + coinGroupId, true, fSkipBlacklisted));
+}
+
+CAnonymitySetCache::BlockCoins CAnonymitySetCache::Get(CBlockIndex *index, const SetKey& key) {
+    {
+        LOCK(cs);
+        auto blockIt = blocks.find(index);
+        if (blockIt != blocks.end()) {
+            auto it = blockIt->second.find(key);
+            if (it != blockIt->second.end()) {
+                lru.splice(lru.begin(), lru, it->second.lruIt);
+                return it->second.coins;
+            }
+        }
+    }
+
+    // build without holding the lock, sigma coins require a multiplication each
+    BlockCoins coins = Build(index, key);
+
+    // most blocks of a group don't mint to it, walking them again is cheap
+    std::size_t nUsage = EntryMemoryUsage(coins);
+    if (coins->empty() || nUsage > nMaxMemoryUsage)
+        return coins;
+
+    LOCK(cs);
+    auto& blockEntries = blocks[index];
+    auto it = blockEntries.find(key);
+    if (it != blockEntries.end())
+        return it->second.coins;
+
+    lru.emplace_front(index, key);
+    blockEntries.emplace(key, Entry{coins, lru.begin()});
+    nMemoryUsage += nUsage;
+    if (!std::get<1>(key))
+        usedSets[key]++;
+
+    while (nMemoryUsage > nMaxMemoryUsage) {
+        auto oldest = lru.back();
+        auto blockIt = blocks.find(oldest.first);
+        EraseEntry(blockIt->second, blockIt->second.find(oldest.second));
+        if (blockIt->second.empty())
+            blocks.erase(blockIt);
+    }
+
+    return coins;
+}
+
+std::size_t CAnonymitySetCache::EntryMemoryUsage(const BlockCoins& coins) {
+    return memusage::DynamicUsage(*coins) + memusage::MallocUsage(sizeof(std::vector<GroupElement>))
+        + memusage::MallocUsage(sizeof(std::pair<const SetKey, Entry>) + 3 * sizeof(void*))
+        + memusage::MallocUsage(sizeof(LruList::value_type) + 2 * sizeof(void*));
+}
+
+void CAnonymitySetCache::EraseEntry(std::map<SetKey, Entry>& blockEntries, std::map<SetKey, Entry>::iterator it) {
+    nMemoryUsage -= EntryMemoryUsage(it->second.coins);
+    lru.erase(it->second.lruIt);
+
+    auto usedIt = usedSets.find(it->first);
+    if (usedIt != usedSets.end() && --usedIt->second == 0)
+        usedSets.erase(usedIt);
+
+    blockEntries.erase(it);
+}
+
+CAnonymitySetCache::BlockCoins CAnonymitySetCache::Build(CBlockIndex *index, const SetKey& key) {
+    const auto &params = ::Params().GetConsensus();
+    int id = std::get<0>(key);
+    bool fSkipBlacklisted = std::get<2>(key);
+
+    std::vector<GroupElement> coins;
+    if (std::get<1>(key)) {
+        int coinGroupId = id % (CENT / 1000);
+        int64_t intDenom = (id - coinGroupId);
+        intDenom *= 1000;
+        sigma::CoinDenomination denomination;
+        sigma::IntegerToDenomination(intDenom, denomination);
+
+        LoadPrivacyPayload(index);
+        auto it = index->sigmaMintedPubCoins.find(std::make_pair(denomination, coinGroupId));
+        if (it != index->sigmaMintedPubCoins.end()) {
+            GroupElement h1Denom = lelantus::Params::get_default()->get_h1() * intDenom;
+            coins.reserve(it->second.size());
+            for (const auto& pubCoin : it->second) {
+                if (fSkipBlacklisted && params.sigmaBlacklist.count(pubCoin.getValue()) > 0)
+                    continue;
+                coins.emplace_back(pubCoin.getValue() + h1Denom);
+            }
+        }
+    } else {
+        LoadPrivacyPayload(index);
+        auto it = index->lelantusMintedPubCoins.find(id);
+        if (it != index->lelantusMintedPubCoins.end()) {
+            coins.reserve(it->second.size());
+            for (const auto& pubCoin : it->second) {
+                if (fSkipBlacklisted && params.lelantusBlacklist.count(pubCoin.first.getValue()) > 0)
+                    continue;
+                coins.emplace_back(pubCoin.first.getValue());
+            }
+        }
+    }
+
+    GroupElement::normalize(coins);
+    return std::make_shared<const std::vector<GroupElement>>(std::move(coins));
+}
+
+void CAnonymitySetCache::AddBlock(CBlockIndex *index) {
+    std::vector<SetKey> keys;
+    {
+        LOCK(cs);
+        for (const auto& used : usedSets) {
+            if (index->lelantusMintedPubCoins.count(std::get<0>(used.first)) > 0)
+                keys.push_back(used.first);
+        }
+    }
+
+    for (const auto& key : keys)
+        Get(index, key);
+}
+
+void CAnonymitySetCache::RemoveBlock(CBlockIndex *index) {
+    LOCK(cs);
+    auto blockIt = blocks.find(index);
+    if (blockIt == blocks.end())
+        return;
+
+    while (!blockIt->second.empty())
+        EraseEntry(blockIt->second, blockIt->second.begin());
+    blocks.erase(blockIt);
+}
+
+void CAnonymitySetCache::Reset() {
+    LOCK(cs);
+    blocks.clear();
+    lru.clear();
+    usedSets.clear();
+    nMemoryUsage = 0;
+}
+
+std::size_t CAnonymitySetCache::GetCachedBlocksCount() const {
+    LOCK(cs);
+    return blocks.size();
+}
+
+std::size_t CAnonymitySetCache::GetMemoryUsage() const {
+    LOCK(cs);
+    return nMemoryUsage;
+}
+
 std::pair<int, int> CLelantusState::GetMintedCoinHeightAndId(
         const lelantus::PublicCoin& pubCoin) {
     auto coinIt = containers.GetMints().find(pubCoin);
@@ -1571,6 +2089,53 @@ void CLelantusState::Reset() {
     coinGroups.clear();
     latestCoinId = 0;
     containers.Reset();
+    anonymitySetCache.Reset();
+
+    LOCK(cs_coinSetSnapshots);
+    coinSetSnapshots.clear();
+}
+
+void CLelantusState::Dump(CAutoFile& file) const {
+    file << latestCoinId;
+
+    WriteCompactSize(file, coinGroups.size());
+    for (const auto& group : coinGroups) {
+        file << group.first;
+        file << (group.second.firstBlock ? group.second.firstBlock->GetBlockHash() : uint256());
+        file << (group.second.lastBlock ? group.second.lastBlock->GetBlockHash() : uint256());
+        file << group.second.nCoins;
+    }
+
+    containers.Dump(file);
+}
+
+void CLelantusState::Load(CAutoFile& file) {
+    Reset();
+
+    auto readBlockIndex = [&file]() -> CBlockIndex* {
+        uint256 hash;
+        file >> hash;
+        if (hash.IsNull())
+            return nullptr;
+        BlockMap::iterator it = mapBlockIndex.find(hash);
+        if (it == mapBlockIndex.end())
+            throw std::runtime_error("CLelantusState::Load: unknown block " + hash.ToString());
+        return it->second;
+    };
+
+    file >> latestCoinId;
+
+    uint64_t nGroups = ReadCompactSize(file);
+    for (uint64_t i = 0; i < nGroups; i++) {
+        int groupId;
+        file >> groupId;
+        LelantusCoinGroupInfo& coinGroup = coinGroups[groupId];
+        coinGroup.firstBlock = readBlockIndex();
+        coinGroup.lastBlock = readBlockIndex();
+        file >> coinGroup.nCoins;
+    }
+
+    containers.Load(file);
 }
 
 CLelantusState* CLelantusState::GetState() {
@@ -1614,9 +2179,8 @@ size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex
             ; coins < required && block
             ; block = block->pprev) {
 
-            size_t inBlock;
-            if (block->lelantusMintedPubCoins.count(groupId)
-                && (inBlock = block->lelantusMintedPubCoins[groupId].size())) {
+            size_t inBlock = CountCoinInBlock(block, groupId);
+            if (inBlock) {
 
                 coins += inBlock;
                 first = block;
@@ -1629,20 +2193,76 @@ size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex
 
 // CLelantusMempoolState
 
-bool CLelantusMempoolState::HasCoinSerial(const Scalar& coinSerial) {
+bool CLelantusMempoolState::HasCoinSerial(const Scalar& coinSerial) const {
     return mempoolCoinSerials.count(coinSerial) > 0;
 }
 
-bool CLelantusMempoolState::HasMint(const GroupElement& pubCoin) {
+bool CLelantusMempoolState::HasMint(const GroupElement& pubCoin) const {
     return mempoolMints.count(pubCoin) > 0;
 }
 
+void CLelantusMempoolState::AddTransaction(const uint256& txHash, const std::vector<Scalar>& coinSerials, const std::vector<GroupElement>& pubCoins) {
+    if (coinSerials.empty() && pubCoins.empty())
+        return;
+
+    TxEntry& entry = mempoolTxs[txHash];
+    entry.coinSerials.reserve(entry.coinSerials.size() + coinSerials.size());
+    for (const Scalar& coinSerial : coinSerials) {
+        if (mempoolCoinSerials.emplace(coinSerial, txHash).second)
+            entry.coinSerials.push_back(coinSerial);
+    }
+
+    entry.pubCoins.reserve(entry.pubCoins.size() + pubCoins.size());
+    for (const GroupElement& pubCoin : pubCoins) {
+        if (mempoolMints.emplace(pubCoin, txHash).second)
+            entry.pubCoins.push_back(pubCoin);
+    }
+}
+
+bool CLelantusMempoolState::RemoveTransaction(const uint256& txHash) {
+    auto it = mempoolTxs.find(txHash);
+    if (it == mempoolTxs.end())
+        return false;
+
+    // entries may have been dropped on their own since, do not touch them if they were reused
+    for (const Scalar& coinSerial : it->second.coinSerials) {
+        auto serialIt = mempoolCoinSerials.find(coinSerial);
+        if (serialIt != mempoolCoinSerials.end() && serialIt->second == txHash)
+            mempoolCoinSerials.erase(serialIt);
+    }
+
+    for (const GroupElement& pubCoin : it->second.pubCoins) {
+        auto mintIt = mempoolMints.find(pubCoin);
+        if (mintIt != mempoolMints.end() && mintIt->second == txHash)
+            mempoolMints.erase(mintIt);
+    }
+
+    mempoolTxs.erase(it);
+    return true;
+}
+
+std::set<uint256> CLelantusMempoolState::GetConflictingTxs(const std::vector<Scalar>& coinSerials, const std::vector<GroupElement>& pubCoins) const {
+    std::set<uint256> result;
+    for (const Scalar& coinSerial : coinSerials) {
+        auto it = mempoolCoinSerials.find(coinSerial);
+        if (it != mempoolCoinSerials.end())
+            result.insert(it->second);
+    }
+
+    for (const GroupElement& pubCoin : pubCoins) {
+        auto it = mempoolMints.find(pubCoin);
+        if (it != mempoolMints.end() && !it->second.IsNull())
+            result.insert(it->second);
+    }
+    return result;
+}
+
 bool CLelantusMempoolState::AddSpendToMempool(const Scalar &coinSerial, uint256 txHash) {
     return mempoolCoinSerials.insert({coinSerial, txHash}).second;
 }
 
 void CLelantusMempoolState::AddMintToMempool(const GroupElement& pubCoin) {
-    mempoolMints.insert(pubCoin);
+    mempoolMints.emplace(pubCoin, uint256());
 }
 
 void CLelantusMempoolState::RemoveMintFromMempool(const GroupElement& pubCoin) {
@@ -1650,10 +2270,11 @@ void CLelantusMempoolState::RemoveMintFromMempool(const GroupElement& pubCoin) {
 }
 
 uint256 CLelantusMempoolState::GetMempoolConflictingTxHash(const Scalar& coinSerial) {
-    if (mempoolCoinSerials.count(coinSerial) == 0)
+    auto it = mempoolCoinSerials.find(coinSerial);
+    if (it == mempoolCoinSerials.end())
         return uint256();
 
-    return mempoolCoinSerials[coinSerial];
+    return it->second;
 }
 
 void CLelantusMempoolState::RemoveSpendFromMempool(const Scalar &coinSerial) {
@@ -1663,6 +2284,7 @@ void CLelantusMempoolState::RemoveSpendFromMempool(const Scalar &coinSerial) {
 void CLelantusMempoolState::Reset() {
     mempoolCoinSerials.clear();
     mempoolMints.clear();
+    mempoolTxs.clear();
 }
 
 
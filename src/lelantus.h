@@ -9,6 +9,12 @@
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
 #include "liblelantus/params.h"
+#include "saltedhasher.h"
+#include "sync.h"
+#include <list>
+#include <memory>
+#include <set>
+#include <tuple>
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
@@ -50,7 +56,8 @@ void ParseLelantusMintScript(const CScript& script, secp_primitives::GroupElemen
 void ParseLelantusJMintScript(const CScript& script, secp_primitives::GroupElement& pubcoin, std::vector<unsigned char>& encryptedValue);
 void ParseLelantusJMintScript(const CScript& script, secp_primitives::GroupElement& pubcoin, std::vector<unsigned char>& encryptedValue, uint256& mintTag);
 void ParseLelantusMintScript(const CScript& script, secp_primitives::GroupElement& pubcoin);
-std::unique_ptr<JoinSplit> ParseLelantusJoinSplit(const CTransaction& tx);
+// Joinsplits verified on mempool acceptance are cached by tx hash and shared between callers, so the result is immutable
+std::shared_ptr<const JoinSplit> ParseLelantusJoinSplit(const CTransaction& tx);
 
 size_t GetSpendInputs(const CTransaction &tx, const CTxIn& in);
 size_t GetSpendInputs(const CTransaction &tx);
@@ -90,7 +97,8 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag);
 
 
-bool BuildLelantusStateFromIndex(CChain *chain);
+// Add blocks of the chain to the state, starting after pindexFrom if the state was loaded up to it
+bool BuildLelantusStateFromIndex(CChain *chain, const CBlockIndex *pindexFrom = nullptr);
 
 std::vector<Scalar> GetLelantusJoinSplitSerialNumbers(const CTransaction &tx, const CTxIn &txin);
 std::vector<uint32_t> GetLelantusJoinSplitIds(const CTransaction &tx, const CTxIn &txin);
@@ -100,18 +108,39 @@ std::vector<uint32_t> GetLelantusJoinSplitIds(const CTransaction &tx, const CTxI
  */
 size_t CountCoinInBlock(CBlockIndex const *index, int id);
 
+/*
+ * Serials and mints of the lelantus transactions in the mempool. Every serial and mint points to the transaction
+ * using it for conflict checks, and every transaction keeps what it added so it is dropped without being parsed
+ * again when it leaves the mempool.
+ */
 class CLelantusMempoolState {
 private:
+    struct TxEntry {
+        std::vector<Scalar> coinSerials;
+        std::vector<GroupElement> pubCoins;
+    };
+
     // serials of spends currently in the mempool mapped to tx hashes
     std::unordered_map<Scalar, uint256, sigma::CScalarHash> mempoolCoinSerials;
-    // mints in the mempool
-    std::unordered_set<GroupElement> mempoolMints;
+    // mints in the mempool mapped to tx hashes, null for mints added on their own
+    std::unordered_map<GroupElement, uint256> mempoolMints;
+    // serials and mints added by every transaction
+    std::unordered_map<uint256, TxEntry, StaticSaltedHasher> mempoolTxs;
 
 public:
     // Check if there is a conflicting tx in the blockchain or mempool
-    bool HasCoinSerial(const Scalar& coinSerial);
+    bool HasCoinSerial(const Scalar& coinSerial) const;
+
+    bool HasMint(const GroupElement& pubCoin) const;
+
+    // Adds serials and mints of the transaction at once, those already used by another transaction are left to it
+    void AddTransaction(const uint256& txHash, const std::vector<Scalar>& coinSerials, const std::vector<GroupElement>& pubCoins);
 
-    bool HasMint(const GroupElement& pubCoin);
+    // Drops serials and mints added by the transaction, returns false if it has added nothing
+    bool RemoveTransaction(const uint256& txHash);
+
+    // Hashes of the transactions spending any of the serials or minting any of the coins
+    std::set<uint256> GetConflictingTxs(const std::vector<Scalar>& coinSerials, const std::vector<GroupElement>& pubCoins) const;
 
     // Add spend into the mempool.
     bool AddSpendToMempool(const Scalar &coinSerial, uint256 txHash);
@@ -130,6 +159,61 @@ public:
     void Reset();
 };
 
+/*
+ * Anonymity set coins kept per block in affine coordinates, ready to be used by verifiers.
+ * Sigma coins used in sigma to lelantus joinsplits are kept with the denomination already added.
+ * Blocks are cached on first use, coins of connected blocks are added for groups which still have cached blocks,
+ * disconnected blocks are dropped. Blocks without coins of the set are not stored and the least recently used
+ * entries are evicted once the coins exceed the memory limit.
+ */
+class CAnonymitySetCache {
+public:
+    typedef std::shared_ptr<const std::vector<GroupElement>> BlockCoins;
+
+    static const std::size_t DEFAULT_MAX_MEMORY_USAGE = 64 << 20;
+
+    explicit CAnonymitySetCache(std::size_t nMaxMemoryUsage = DEFAULT_MAX_MEMORY_USAGE) : nMaxMemoryUsage(nMaxMemoryUsage) {}
+
+    // Lelantus coins of the group minted in the block
+    BlockCoins GetLelantusCoins(CBlockIndex *index, int coinGroupId, bool fSkipBlacklisted);
+
+    // Sigma coins of the denomination and group minted in the block, h1 * denomination is added to every coin
+    BlockCoins GetSigmaCoins(CBlockIndex *index, sigma::CoinDenomination denomination, int coinGroupId, bool fSkipBlacklisted);
+
+    void AddBlock(CBlockIndex *index);
+    void RemoveBlock(CBlockIndex *index);
+    void Reset();
+
+    std::size_t GetCachedBlocksCount() const;
+    std::size_t GetMemoryUsage() const;
+
+private:
+    // (group id as used in joinsplits, is sigma group, skip blacklisted)
+    typedef std::tuple<int, bool, bool> SetKey;
+    typedef std::list<std::pair<const CBlockIndex*, SetKey>> LruList;
+
+    struct Entry {
+        BlockCoins coins;
+        LruList::iterator lruIt;
+    };
+
+    BlockCoins Get(CBlockIndex *index, const SetKey& key);
+    static BlockCoins Build(CBlockIndex *index, const SetKey& key);
+    static std::size_t EntryMemoryUsage(const BlockCoins& coins);
+
+    void EraseEntry(std::map<SetKey, Entry>& blockEntries, std::map<SetKey, Entry>::iterator it);
+
+private:
+    mutable CCriticalSection cs;
+    std::unordered_map<const CBlockIndex*, std::map<SetKey, Entry>> blocks;
+    // most recently used entries first
+    LruList lru;
+    // number of cached blocks of every lelantus set, sets are extended when blocks are connected
+    std::map<SetKey, std::size_t> usedSets;
+    std::size_t nMemoryUsage = 0;
+    const std::size_t nMaxMemoryUsage;
+};
+
 /*
  * State of minted/spent coins as extracted from the index
  */
@@ -191,17 +275,50 @@ public:
         std::vector<lelantus::PublicCoin>& coins_out,
         std::vector<unsigned char>& setHash_out);
 
+    // Anonymity set for spends as returned by GetCoinSetForSpend, immutable and shared by all readers
+    struct CoinSetForSpend {
+        int nCoins = 0;
+        uint256 blockHash;
+        std::vector<lelantus::PublicCoin> coins;
+        std::vector<unsigned char> setHash;
+    };
+
+    // Same as GetCoinSetForSpend without copying the coins, the set is only rebuilt once its latest block changes
+    std::shared_ptr<const CoinSetForSpend> GetCoinSetSnapshotForSpend(
+        CChain *chain,
+        int maxHeight,
+        int id);
+
     void GetAnonymitySet(
             int coinGroupID,
             bool fStartLelantusBlacklist,
             std::vector<lelantus::PublicCoin>& coins_out);
 
+    // Same as above, coins are taken from the anonymity set cache
+    void GetAnonymitySet(
+            int coinGroupID,
+            bool fStartLelantusBlacklist,
+            std::vector<GroupElement>& coins_out);
+
+    // Anonymity set of sigma coins spent in sigma to lelantus joinsplits, h1 * denomination is added to every coin
+    void GetSigmaToLelantusAnonymitySet(
+            sigma::CoinDenomination denomination,
+            int coinGroupID,
+            bool fStartSigmaBlacklist,
+            std::vector<GroupElement>& coins_out);
+
+    CAnonymitySetCache& GetAnonymitySetCache() { return anonymitySetCache; }
+
     // Return height of mint transaction and id of minted coin
     std::pair<int, int> GetMintedCoinHeightAndId(const lelantus::PublicCoin& pubCoin);
 
     // Reset to initial values
     void Reset();
 
+    // Write the state to the file or read it back instead of adding every block at startup, throws on failure
+    void Dump(CAutoFile& file) const;
+    void Load(CAutoFile& file);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool CanAddSpendToMempool(const Scalar& coinSerial);
 
@@ -236,6 +353,8 @@ public:
 private:
     size_t CountLastNCoins(int groupId, size_t required, CBlockIndex* &first);
 
+    std::shared_ptr<const CoinSetForSpend> BuildCoinSetForSpend(CBlockIndex *head, int coinGroupID, bool fSkipBlacklisted);
+
 private:
     // Group Limit
     size_t maxCoinInGroup;
@@ -263,6 +382,9 @@ private:
 
         void Reset();
 
+        void Dump(CAutoFile& file) const;
+        void Load(CAutoFile& file);
+
         mint_info_container const & GetMints() const;
         std::unordered_map<Scalar, int> const & GetSpends() const;
         std::unordered_map<uint256, lelantus::PublicCoin>& GetTagToPublicCoin();
@@ -289,6 +411,17 @@ private:
 
     Containers containers;
 
+    CAnonymitySetCache anonymitySetCache;
+
+    // Latest anonymity set for spends of every group with the block it was built up to
+    struct CoinSetSnapshot {
+        const CBlockIndex *head;
+        bool fSkipBlacklisted;
+        std::shared_ptr<const CoinSetForSpend> coinSet;
+    };
+    CCriticalSection cs_coinSetSnapshots;
+    std::unordered_map<int, CoinSetSnapshot> coinSetSnapshots;
+
     friend class lelantus_mintspend::lelantus_mintspend_test;
 };
 
@@ -1,4 +1,5 @@
 #include "innerproduct_proof_generator.h"
+#include "threadpool.h"
 
 namespace lelantus {
     
@@ -60,15 +61,27 @@ void InnerProductProofGenerator::generate_proof_util(
     }
 
     std::size_t n = a.size() / 2;
-    // Computes cL then L
-    Scalar cL = LelantusPrimitives::scalar_dot_product(a.begin() ,a.begin() + n, b.begin() + n,  b.end());
-    GroupElement L;
-    l(a.begin() ,a.begin() + n, b.begin() + n,  b.end(), cL, L);
-
-    //Computes cR then R
-    Scalar cR = LelantusPrimitives::scalar_dot_product(a.begin() + n, a.end(), b.begin(), b.begin() + n);
-    GroupElement R;
-    r(a.begin() + n, a.end(), b.begin(), b.begin() + n, cR, R);
+    DoNotDisturb dnd;
+    GroupElement L, R;
+    {
+        WorkStealingThreadPool::TaskGroup tasks;
+        // Computes cL then L
+        tasks.Run([&]() {
+            Scalar cL = LelantusPrimitives::scalar_dot_product(a.begin() ,a.begin() + n, b.begin() + n,  b.end());
+            l(a.begin() ,a.begin() + n, b.begin() + n,  b.end(), cL, L);
+            return true;
+        });
+
+        //Computes cR then R
+        tasks.Run([&]() {
+            Scalar cR = LelantusPrimitives::scalar_dot_product(a.begin() + n, a.end(), b.begin(), b.begin() + n);
+            r(a.begin() + n, a.end(), b.begin(), b.begin() + n, cR, R);
+            return true;
+        });
+
+        if (!tasks.Wait())
+            throw std::runtime_error("Inner product proof creation failed.");
+    }
 
     //Push L and R
     proof_out.L_.emplace_back(L);
@@ -88,9 +101,14 @@ void InnerProductProofGenerator::generate_proof_util(
 
     //Compute g prime and p prime
     std::vector<GroupElement> g_p;
-    LelantusPrimitives::g_prime(g_, x, g_p);
     std::vector<GroupElement> h_p;
-    LelantusPrimitives::h_prime(h_, x, h_p);
+    {
+        WorkStealingThreadPool::TaskGroup tasks;
+        tasks.Run([&]() { LelantusPrimitives::g_prime(g_, x, g_p); return true; });
+        tasks.Run([&]() { LelantusPrimitives::h_prime(h_, x, h_p); return true; });
+        if (!tasks.Wait())
+            throw std::runtime_error("Inner product proof creation failed.");
+    }
 
     //Compute a prime and b prime
     std::vector<Scalar> a_p = a_prime(x, a);
@@ -108,10 +126,13 @@ void InnerProductProofGenerator::compute_P(
         const std::vector<Scalar>& b,
         GroupElement& result_out) {
 
-    secp_primitives::MultiExponent g_mult(g_, a);
-    secp_primitives::MultiExponent h_mult(h_, b);
-    GroupElement g = g_mult.get_multiple();
-    GroupElement h = h_mult.get_multiple();
+    GroupElement g, h;
+    DoNotDisturb dnd;
+    WorkStealingThreadPool::TaskGroup tasks;
+    tasks.Run([&]() { g = secp_primitives::MultiExponent(g_, a).get_multiple(); return true; });
+    tasks.Run([&]() { h = secp_primitives::MultiExponent(h_, b).get_multiple(); return true; });
+    if (!tasks.Wait())
+        throw std::runtime_error("Inner product proof creation failed.");
     result_out = (g + h);
 }
 
@@ -50,21 +50,21 @@ public:
         version = nVersion;
     }
 
-    const std::vector<Scalar>& getCoinSerialNumbers();
+    const std::vector<Scalar>& getCoinSerialNumbers() const;
 
-    const LelantusProof& getLelantusProof();
+    const LelantusProof& getLelantusProof() const;
 
-    uint64_t getFee();
+    uint64_t getFee() const;
 
-    const std::vector<uint32_t>& getCoinGroupIds();
+    const std::vector<uint32_t>& getCoinGroupIds() const;
 
-    const std::vector<std::pair<uint32_t, uint256>>& getIdAndBlockHashes();
+    const std::vector<std::pair<uint32_t, uint256>>& getIdAndBlockHashes() const;
 
     int getVersion() const {
         return version;
     }
 
-    bool getIndex(const PublicCoin& coin, const std::vector<PublicCoin>& anonymity_set, size_t& index);
+    bool getIndex(const PublicCoin& coin, const std::vector<PublicCoin>& anonymity_set, size_t& index) const;
 
     bool HasValidSerials() const;
 
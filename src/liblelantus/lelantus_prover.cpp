@@ -36,9 +36,20 @@ void LelantusProver::proof(
     Yk_sum.resize(Cin.size());
     // we are passing challengeGenerator ptr here, as after LELANTUS_TX_VERSION_4_5 we need  it back, with filled data, to use in schnorr proof,
     std::unique_ptr<ChallengeGenerator> challengeGenerator;
-    generate_sigma_proofs(anonymity_sets, anonymity_set_hashes, Cin, Cout, indexes, ecdsaPubkeys, x, challengeGenerator, Yk_sum, proof_out.sigma_proofs, qkSchnorrProof);
+    {
+        // range proofs don't depend on the sigma transcript, create them concurrently
+        DoNotDisturb dnd;
+        WorkStealingThreadPool::TaskGroup tasks;
+        tasks.Run([&]() {
+            generate_bulletproofs(Cout, proof_out.bulletproofs);
+            return true;
+        });
+
+        generate_sigma_proofs(anonymity_sets, anonymity_set_hashes, Cin, Cout, indexes, ecdsaPubkeys, x, challengeGenerator, Yk_sum, proof_out.sigma_proofs, qkSchnorrProof);
 
-    generate_bulletproofs(Cout, proof_out.bulletproofs);
+        if (!tasks.Wait())
+            throw std::runtime_error("Lelantus proof creation failed.");
+    }
 
     Scalar x_m = x.exponent(params->get_sigma_m());
 
@@ -104,78 +115,57 @@ void LelantusProver::generate_sigma_proofs(
     std::vector<Scalar> serialNumbers;
     serialNumbers.reserve(N);
 
-    std::size_t threadsMaxCount = std::min((unsigned int)N, boost::thread::hardware_concurrency());
-    std::vector<boost::shared_future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
-
     std::vector<std::vector<GroupElement>> C_;
     C_.resize(N);
     DoNotDisturb dnd;
-    for (std::size_t j = 0; j < N; j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < N) {
-                if (!c.count(Cin[i].second))
-                    throw std::invalid_argument("No such anonymity set or id is not correct");
-
-                GroupElement gs = (params->get_g() * Cin[i].first.getSerialNumber().negate());
-                serialNumbers.emplace_back(Cin[i].first.getSerialNumber());
-
-                C_[i].reserve(c.size());
-
-                const auto& set = c.find(Cin[i].second);
-                if (set == c.end())
-                    throw std::invalid_argument("No such anonymity set");
-
-                for (auto const &coin : set->second)
-                    C_[i].emplace_back(coin.getValue() + gs);
-
-                rA[i].randomize();
-                rB[i].randomize();
-                rC[i].randomize();
-                rD[i].randomize();
-                Tk[i].resize(params->get_sigma_m());
-                Pk[i].resize(params->get_sigma_m());
-                Yk[i].resize(params->get_sigma_m());
-                a[i].resize(params->get_sigma_n() * params->get_sigma_m());
-
-                auto& sigma_i = sigma[i];
-                auto& rA_i = rA[i];
-                auto& rB_i = rB[i];
-                auto& rC_i = rC[i];
-                auto& rD_i = rD[i];
-                auto& a_i = a[i];
-                auto& Tk_i = Tk[i];
-                auto& Pk_i = Pk[i];
-                auto& Yk_i = Yk[i];
-                auto& prover = sigmaProver;
-                auto& commits = C_[i];
-                auto& index = indexes[i];
-                auto& proof = sigma_proofs[i];
-                parallelTasks.emplace_back(threadPool.PostTask([&]() {
-                    try {
-                        prover.sigma_commit(commits, index, rA_i, rB_i, rC_i, rD_i, a_i, Tk_i, Pk_i, Yk_i, sigma_i, proof);
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-            } else
-                break;
-        }
-
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
-
-        if (isFail)
-            throw std::runtime_error("Lelantus proof creation failed.");
-
-        parallelTasks.clear();
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!c.count(Cin[i].second))
+            throw std::invalid_argument("No such anonymity set or id is not correct");
+
+        GroupElement gs = (params->get_g() * Cin[i].first.getSerialNumber().negate());
+        serialNumbers.emplace_back(Cin[i].first.getSerialNumber());
+
+        const auto& set = c.find(Cin[i].second);
+        if (set == c.end())
+            throw std::invalid_argument("No such anonymity set");
+
+        rA[i].randomize();
+        rB[i].randomize();
+        rC[i].randomize();
+        rD[i].randomize();
+        Tk[i].resize(params->get_sigma_m());
+        Pk[i].resize(params->get_sigma_m());
+        Yk[i].resize(params->get_sigma_m());
+        a[i].resize(params->get_sigma_n() * params->get_sigma_m());
+
+        auto& sigma_i = sigma[i];
+        auto& rA_i = rA[i];
+        auto& rB_i = rB[i];
+        auto& rC_i = rC[i];
+        auto& rD_i = rD[i];
+        auto& a_i = a[i];
+        auto& Tk_i = Tk[i];
+        auto& Pk_i = Pk[i];
+        auto& Yk_i = Yk[i];
+        auto& prover = sigmaProver;
+        auto& commits = C_[i];
+        auto& coins = set->second;
+        auto& index = indexes[i];
+        auto& proof = sigma_proofs[i];
+        tasks.Run([&, gs]() {
+            commits.reserve(coins.size());
+            for (auto const &coin : coins)
+                commits.emplace_back(coin.getValue() + gs);
+
+            prover.sigma_commit(commits, index, rA_i, rB_i, rC_i, rD_i, a_i, Tk_i, Pk_i, Yk_i, sigma_i, proof);
+            return true;
+        });
     }
 
+    if (!tasks.Wait())
+        throw std::runtime_error("Lelantus proof creation failed.");
+
     std::vector<GroupElement> PubcoinsOut;
     PubcoinsOut.reserve(Cout.size());
     for(auto coin : Cout)
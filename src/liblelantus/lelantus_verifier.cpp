@@ -118,7 +118,7 @@ bool LelantusVerifier::verify_sigma(
             x);
 
     SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
-                                                          params->get_sigma_m());
+                                                          params->get_sigma_m(), params->get_sigma_fixed_bases());
 
     if (Sin.size() != anonymity_sets.size())
         throw std::invalid_argument("Number of anonymity sets and number of vectors containing serial numbers must be equal");
@@ -99,6 +99,17 @@ const std::vector<GroupElement>& Params::get_sigma_h() const {
     return h_sigma;
 }
 
+const FixedBaseMultiExponent* Params::get_sigma_fixed_bases() const {
+    std::call_once(sigma_fixed_bases_flag, [this] {
+        std::vector<GroupElement> bases;
+        bases.reserve(h_sigma.size() + 1);
+        bases.emplace_back(g);
+        bases.insert(bases.end(), h_sigma.begin(), h_sigma.end());
+        sigma_fixed_bases.reset(new FixedBaseMultiExponent(bases));
+    });
+    return sigma_fixed_bases.get();
+}
+
 const std::vector<GroupElement>& Params::get_bulletproofs_g() const {
     return g_rangeProof;
 }
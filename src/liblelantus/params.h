@@ -3,9 +3,12 @@
 
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
+#include <secp256k1/include/MultiExponent.h>
 #include <serialize.h>
 #include <sync.h>
 
+#include <mutex>
+
 using namespace secp_primitives;
 
 namespace lelantus {
@@ -25,6 +28,8 @@ public:
     int get_bulletproofs_max_m() const;
     const Scalar& get_limit_range() const;
     const GroupElement& get_h1_limit_range() const;
+    // Precomputed tables for g followed by sigma h generators, built on first use
+    const FixedBaseMultiExponent* get_sigma_fixed_bases() const;
 
 private:
     Params(const GroupElement& g_sigma_, int n, int m, int n_rangeProof_, int max_m_rangeProof_);
@@ -36,6 +41,8 @@ private:
     //sigma params
     GroupElement g;
     std::vector<GroupElement> h_sigma;
+    mutable std::once_flag sigma_fixed_bases_flag;
+    mutable std::unique_ptr<FixedBaseMultiExponent> sigma_fixed_bases;
     int n_sigma;
     int m_sigma;
 
@@ -1,7 +1,11 @@
 #include "range_prover.h"
 #include "challenge_generator_impl.h"
+#include "threadpool.h"
 
 namespace lelantus {
+
+// Generators processed by a single task of the prover
+static const std::size_t RANGE_PROVER_CHUNK_SIZE = 64;
     
 RangeProver::RangeProver(
         const GroupElement& g,
@@ -60,7 +64,6 @@ void RangeProver::proof(
 
     Scalar alpha;
     alpha.randomize();
-    LelantusPrimitives::commit(h1, alpha, g_, aL, h_, aR, proof_out.A);
 
     std::vector<Scalar> sL, sR;
     sL.resize(n * m);
@@ -73,7 +76,15 @@ void RangeProver::proof(
 
     Scalar ro;
     ro.randomize();
-    LelantusPrimitives::commit(h1, ro, g_, sL, h_, sR, proof_out.S);
+
+    DoNotDisturb dnd;
+    {
+        WorkStealingThreadPool::TaskGroup tasks;
+        tasks.Run([&]() { LelantusPrimitives::commit(h1, alpha, g_, aL, h_, aR, proof_out.A); return true; });
+        tasks.Run([&]() { LelantusPrimitives::commit(h1, ro, g_, sL, h_, sR, proof_out.S); return true; });
+        if (!tasks.Wait())
+            throw std::runtime_error("Range proof creation failed.");
+    }
 
     Scalar y, z;
     std::unique_ptr<ChallengeGenerator> challengeGenerator;
@@ -165,15 +176,20 @@ void RangeProver::proof(
     proof_out.T_x2 = T_22 * x.square() + T_21 * x + z_sum2;
     proof_out.u = alpha + ro * x;
 
-    //compute h'
+    //compute h', every chunk starts from its own power of y^-1
     std::vector<GroupElement> h_prime;
-    h_prime.reserve(h_.size());
-    NthPower y_i_inv(y.inverse());
-    for (std::size_t i = 0; i < h_.size(); ++i)
-    {
-        h_prime.emplace_back(h_[i] * y_i_inv.pow);
-        y_i_inv.go_next();
-    }
+    h_prime.resize(h_.size());
+    Scalar y_inv = y.inverse();
+    bool fSuccess = ParallelForChunks(h_.size(), RANGE_PROVER_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        NthPower y_i_inv(y_inv, y_inv.exponent(uint64_t(begin)));
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            h_prime[i] = h_[i] * y_i_inv.pow;
+            y_i_inv.go_next();
+        }
+    });
+    if (!fSuccess)
+        throw std::runtime_error("Range proof creation failed.");
 
     int inner_product_version = version >= LELANTUS_TX_VERSION_4_5 ? 2 : 1;
     if (version >= LELANTUS_TX_TPAYLOAD)
@@ -14,8 +14,29 @@ bool SchnorrVerifier::verify(
         const SchnorrProof& proof,
         std::unique_ptr<ChallengeGenerator>& challengeGenerator){
 
-    const GroupElement& u = proof.u;
     Scalar c;
+    get_challenge(y, a, b, proof, challengeGenerator, c);
+
+    if (!membership_checks(y, proof))
+        return false;
+
+    GroupElement right = y * c + g_ * proof.P1 + h_ * proof.T1;
+    if (proof.u == right) {
+        return true;
+    }
+
+    return false;
+}
+
+void SchnorrVerifier::get_challenge(
+        const GroupElement& y,
+        const GroupElement& a,
+        const GroupElement& b,
+        const SchnorrProof& proof,
+        std::unique_ptr<ChallengeGenerator>& challengeGenerator,
+        Scalar& c) const {
+
+    const GroupElement& u = proof.u;
     std::vector<GroupElement> group_elements = {u};
 
     std::string shts = "";
@@ -29,20 +50,55 @@ bool SchnorrVerifier::verify(
     }
     challengeGenerator->add(group_elements);
     challengeGenerator->get_challenge(c);
+}
 
-    const Scalar P1 = proof.P1;
-    const Scalar T1 = proof.T1;
+bool SchnorrVerifier::batch_verify(
+        const std::vector<GroupElement>& y,
+        const std::vector<Scalar>& challenges,
+        const std::vector<SchnorrProof>& proofs) const {
 
-    if (!(u.isMember() && y.isMember() && P1.isMember() && T1.isMember()) ||
-        u.isInfinity() || y.isInfinity() || P1.isZero() || T1.isZero())
+    std::size_t proofsCount = proofs.size();
+    if (y.size() != proofsCount || challenges.size() != proofsCount)
         return false;
-
-    GroupElement right = y * c + g_ * P1 + h_ * T1;
-    if (u == right) {
+    if (proofsCount == 0)
         return true;
+
+    // points are g, h, then y and u of every proof
+    std::vector<GroupElement> points;
+    std::vector<Scalar> exponents;
+    points.reserve(2 * proofsCount + 2);
+    exponents.reserve(2 * proofsCount + 2);
+    points.emplace_back(g_);
+    points.emplace_back(h_);
+    exponents.emplace_back(uint64_t(0));
+    exponents.emplace_back(uint64_t(0));
+
+    for (std::size_t i = 0; i < proofsCount; ++i) {
+        if (!membership_checks(y[i], proofs[i]))
+            return false;
+
+        Scalar w;
+        w.randomize();
+
+        exponents[0] += w * proofs[i].P1;
+        exponents[1] += w * proofs[i].T1;
+        points.emplace_back(y[i]);
+        exponents.emplace_back(w * challenges[i]);
+        points.emplace_back(proofs[i].u);
+        exponents.emplace_back(w.negate());
     }
 
-    return false;
+    secp_primitives::MultiExponent mult(points, exponents);
+    return mult.get_multiple().isInfinity();
+}
+
+bool SchnorrVerifier::membership_checks(const GroupElement& y, const SchnorrProof& proof) const {
+    const GroupElement& u = proof.u;
+    const Scalar& P1 = proof.P1;
+    const Scalar& T1 = proof.T1;
+
+    return (u.isMember() && y.isMember() && P1.isMember() && T1.isMember()) &&
+        !(u.isInfinity() || y.isInfinity() || P1.isZero() || T1.isZero());
 }
 
 bool SchnorrVerifier::verify(
@@ -14,6 +14,16 @@ public:
     bool verify(const GroupElement& y, const GroupElement& a, const GroupElement& b,const SchnorrProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator);
     bool verify(const GroupElement& y, const std::vector<GroupElement>& groupElements,const SchnorrProof& proof);
 
+    // computes the challenge verify(y, a, b, proof, challengeGenerator) checks the proof with
+    void get_challenge(const GroupElement& y, const GroupElement& a, const GroupElement& b, const SchnorrProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator, Scalar& c) const;
+
+    // checks u == y * c + g * P1 + h * T1 for all proofs at once, every equation is multiplied by a random weight
+    // and all of them are added up into a single multiexponentiation
+    bool batch_verify(const std::vector<GroupElement>& y, const std::vector<Scalar>& challenges, const std::vector<SchnorrProof>& proofs) const;
+
+private:
+    bool membership_checks(const GroupElement& y, const SchnorrProof& proof) const;
+
 private:
     const GroupElement& g_;
     const GroupElement& h_;
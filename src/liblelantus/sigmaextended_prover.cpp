@@ -1,7 +1,11 @@
 #include "sigmaextended_prover.h"
+#include "threadpool.h"
 
 namespace lelantus {
 
+// Anonymity set elements processed by a single task of the prover
+static const std::size_t SIGMA_PROVER_CHUNK_SIZE = 4096;
+
 SigmaExtendedProver::SigmaExtendedProver(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
@@ -55,9 +59,6 @@ void SigmaExtendedProver::sigma_commit(
         Yk[k].randomize();
     }
 
-    //compute B
-    LelantusPrimitives::commit(g_, h_, sigma, rB, proof_out.B_);
-
     //compute A
     for (std::size_t j = 0; j < m_; ++j)
     {
@@ -67,7 +68,6 @@ void SigmaExtendedProver::sigma_commit(
             a[j * n_] -= a[j * n_ + i];
         }
     }
-    LelantusPrimitives::commit(g_, h_, a, rA, proof_out.A_);
 
     //compute C
     std::vector<Scalar> c;
@@ -78,7 +78,6 @@ void SigmaExtendedProver::sigma_commit(
     {
         c[i] = a[i] * (one - two * sigma[i]);
     }
-    LelantusPrimitives::commit(g_,h_, c, rC, proof_out.C_);
 
     //compute D
     std::vector<Scalar> d;
@@ -87,20 +86,6 @@ void SigmaExtendedProver::sigma_commit(
     {
         d[i] = a[i].square().negate();
     }
-    LelantusPrimitives::commit(g_,h_, d, rD, proof_out.D_);
-
-    std::vector<std::vector<Scalar>> P_i_k;
-    P_i_k.resize(setSize);
-    for (std::size_t i = 0; i < setSize - 1; ++i)
-    {
-        std::vector<Scalar>& coefficients = P_i_k[i];
-        std::vector<std::size_t> I = LelantusPrimitives::convert_to_nal(i, n_, m_);
-        coefficients.push_back(a[I[0]]);
-        coefficients.push_back(sigma[I[0]]);
-        for (std::size_t j = 1; j < m_; ++j) {
-            LelantusPrimitives::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
-        }
-    }
 
     /*
      * To optimize calculation of sum of all polynomials indices 's' = setSize-1 through 'n^m-1' we use the
@@ -149,19 +134,67 @@ void SigmaExtendedProver::sigma_commit(
             p_i_sum[j + k] += polynomial[k];
     }
 
-    P_i_k[setSize - 1] = p_i_sum;
+    // Commitments and polynomial coefficients are independent, the anonymity set is split into chunks,
+    // each chunk computes coefficients of its polynomials and its share of every G_k
+    std::size_t chunks = (setSize + SIGMA_PROVER_CHUNK_SIZE - 1) / SIGMA_PROVER_CHUNK_SIZE;
+    std::vector<std::vector<GroupElement>> partialGk(chunks);
+
+    DoNotDisturb dnd;
+    WorkStealingThreadPool::TaskGroup tasks;
+    tasks.Run([&]() { LelantusPrimitives::commit(g_, h_, sigma, rB, proof_out.B_); return true; });
+    tasks.Run([&]() { LelantusPrimitives::commit(g_, h_, a, rA, proof_out.A_); return true; });
+    tasks.Run([&]() { LelantusPrimitives::commit(g_, h_, c, rC, proof_out.C_); return true; });
+    tasks.Run([&]() { LelantusPrimitives::commit(g_, h_, d, rD, proof_out.D_); return true; });
+
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        tasks.Run([&, chunk]() {
+            std::size_t begin = chunk * SIGMA_PROVER_CHUNK_SIZE;
+            std::size_t end = std::min(setSize, begin + SIGMA_PROVER_CHUNK_SIZE);
+
+            // P_i_k[k][i - begin] is the k-th coefficient of p_i(x)
+            std::vector<std::vector<Scalar>> P_i_k(m_);
+            for (auto& P_i : P_i_k)
+                P_i.reserve(end - begin);
+
+            std::vector<Scalar> coefficients;
+            coefficients.reserve(m_ + 1);
+            for (std::size_t i = begin; i < end; ++i) {
+                if (i == setSize - 1) {
+                    coefficients = p_i_sum;
+                } else {
+                    std::vector<std::size_t> I_i = LelantusPrimitives::convert_to_nal(i, n_, m_);
+                    coefficients.clear();
+                    coefficients.push_back(a[I_i[0]]);
+                    coefficients.push_back(sigma[I_i[0]]);
+                    for (std::size_t j = 1; j < m_; ++j) {
+                        LelantusPrimitives::new_factor(sigma[j * n_ + I_i[j]], a[j * n_ + I_i[j]], coefficients);
+                    }
+                }
+
+                for (std::size_t k = 0; k < m_; ++k)
+                    P_i_k[k].emplace_back(coefficients[k]);
+            }
+
+            std::vector<GroupElement> chunkCommits(commits.begin() + begin, commits.begin() + end);
+            partialGk[chunk].reserve(m_);
+            for (std::size_t k = 0; k < m_; ++k) {
+                secp_primitives::MultiExponent mult(chunkCommits, P_i_k[k]);
+                partialGk[chunk].emplace_back(mult.get_multiple());
+            }
+            return true;
+        });
+    }
+
+    if (!tasks.Wait())
+        throw std::runtime_error("Sigma proof creation failed.");
 
     proof_out.Gk_.reserve(m_);
     proof_out.Qk.reserve(m_);
     for (std::size_t k = 0; k < m_; ++k)
     {
-        std::vector<Scalar> P_i;
-        P_i.reserve(setSize);
-        for (std::size_t i = 0; i < setSize; ++i){
-            P_i.emplace_back(P_i_k[i][k]);
-        }
-        secp_primitives::MultiExponent mult(commits, P_i);
-        GroupElement c_k = mult.get_multiple();
+        GroupElement c_k;
+        for (const auto& chunkGk : partialGk)
+            c_k += chunkGk[k];
         proof_out.Gk_.emplace_back(c_k + h_[0] * Yk[k].negate());
         proof_out.Qk.emplace_back(LelantusPrimitives::double_commit(g_, Scalar(uint64_t(0)), h_[1], Pk[k], h_[0], Tk[k]) + h_[0] * Yk[k]);
 
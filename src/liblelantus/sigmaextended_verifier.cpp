@@ -7,11 +7,13 @@ SigmaExtendedVerifier::SigmaExtendedVerifier(
         const GroupElement& g,
         const std::vector<GroupElement>& h_gens,
         std::size_t n,
-        std::size_t m)
+        std::size_t m,
+        const FixedBaseMultiExponent* fixedBases)
         : g_(g)
         , h_(h_gens)
         , n(n)
-        , m(m){
+        , m(m)
+        , fixedBases(fixedBases){
 }
 
 // Verify a single one-of-many proof
@@ -102,6 +104,51 @@ bool SigmaExtendedVerifier::batchverify(
     );
 }
 
+// Verify batches of one-of-many proofs against several commitment sets
+// Each proof has a separate challenge and specified set size, all equations are checked in a single multiexponentiation
+bool SigmaExtendedVerifier::batchverify_groups(
+        const std::vector<const std::vector<GroupElement>*>& commits,
+        const std::vector<std::vector<Scalar>>& challenges,
+        const std::vector<std::vector<Scalar>>& serials,
+        const std::vector<std::vector<std::size_t>>& setSizes,
+        const std::vector<std::vector<SigmaExtendedProof>>& proofs) const {
+    std::size_t groups = commits.size();
+    if (groups == 0) {
+        LogPrintf("Cannot have empty group list");
+        return false;
+    }
+    if (challenges.size() != groups || serials.size() != groups || setSizes.size() != groups || proofs.size() != groups) {
+        LogPrintf("Invalid number of groups provided");
+        return false;
+    }
+
+    Scalar g_scalar = Scalar(uint64_t(0)); // associated to g_
+    Scalar h1_scalar = Scalar(uint64_t(0)); // associated to h1
+    Scalar h2_scalar = Scalar(uint64_t(0)); // associated to h2
+    std::vector<Scalar> h_scalars(n * m, Scalar(uint64_t(0))); // associated to h_
+    std::vector<GroupElement> points;
+    std::vector<Scalar> scalars;
+
+    // Reserve space for all groups at once
+    std::size_t final_size = 3 + m * n; // g, h1, h2, (h_)
+    for (std::size_t i = 0; i < groups; i++) {
+        final_size += commits[i]->size();
+        for (const auto& proof : proofs[i])
+            final_size += 4 + proof.Gk_.size() + proof.Qk.size(); // A, B, C, D, (G), (Q)
+    }
+    points.reserve(final_size);
+    scalars.reserve(final_size);
+
+    // Every proof has its own random weights, so equations of different groups can be simply summed up
+    for (std::size_t i = 0; i < groups; i++) {
+        if (!add_batch(*commits[i], challenges[i], serials[i], setSizes[i], false, true, proofs[i],
+                       g_scalar, h1_scalar, h2_scalar, h_scalars, points, scalars))
+            return false;
+    }
+
+    return verify_batch(g_scalar, h1_scalar, h2_scalar, h_scalars, points, scalars);
+}
+
 // Verify a batch of one-of-many proofs
 bool SigmaExtendedVerifier::verify(
         const std::vector<GroupElement>& commits,
@@ -111,6 +158,35 @@ bool SigmaExtendedVerifier::verify(
         const bool commonChallenge,
         const bool specifiedSetSizes,
         const std::vector<SigmaExtendedProof>& proofs) const {
+    Scalar g_scalar = Scalar(uint64_t(0)); // associated to g_
+    Scalar h1_scalar = Scalar(uint64_t(0)); // associated to h1
+    Scalar h2_scalar = Scalar(uint64_t(0)); // associated to h2
+    std::vector<Scalar> h_scalars(n * m, Scalar(uint64_t(0))); // associated to h_
+    std::vector<GroupElement> points;
+    std::vector<Scalar> scalars;
+
+    if (!add_batch(commits, challenges, serials, setSizes, commonChallenge, specifiedSetSizes, proofs,
+                   g_scalar, h1_scalar, h2_scalar, h_scalars, points, scalars))
+        return false;
+
+    return verify_batch(g_scalar, h1_scalar, h2_scalar, h_scalars, points, scalars);
+}
+
+// Add weighted verification equations of a batch of one-of-many proofs against a single commitment set
+bool SigmaExtendedVerifier::add_batch(
+        const std::vector<GroupElement>& commits,
+        const std::vector<Scalar>& challenges,
+        const std::vector<Scalar>& serials,
+        const std::vector<std::size_t>& setSizes,
+        const bool commonChallenge,
+        const bool specifiedSetSizes,
+        const std::vector<SigmaExtendedProof>& proofs,
+        Scalar& g_scalar,
+        Scalar& h1_scalar,
+        Scalar& h2_scalar,
+        std::vector<Scalar>& h_scalars,
+        std::vector<GroupElement>& points,
+        std::vector<Scalar>& scalars) const {
     // Sanity checks
     if (n < 2 || m < 2) {
         LogPrintf("Verifier parameters are invalid");
@@ -148,6 +224,14 @@ bool SigmaExtendedVerifier::verify(
         return false;
     }
 
+    // Specified set sizes must fit into the commitment set
+    for (std::size_t t = 0; specifiedSetSizes && t < M; ++t) {
+        if (setSizes[t] == 0 || setSizes[t] > commits.size()) {
+            LogPrintf("Invalid set size");
+            return false;
+        }
+    }
+
     // All proof elements must be valid
     for (std::size_t t = 0; t < M; ++t) {
         if (!membership_checks(proofs[t])) {
@@ -156,27 +240,15 @@ bool SigmaExtendedVerifier::verify(
         }
     }
 
-    // Final batch multiscalar multiplication
-    Scalar g_scalar = Scalar(uint64_t(0)); // associated to g_
-    Scalar h1_scalar = Scalar(uint64_t(0)); // associated to h1
-    Scalar h2_scalar = Scalar(uint64_t(0)); // associated to h2
-    std::vector<Scalar> h_scalars; // associated to h_
     std::vector<Scalar> commit_scalars; // associated to commitment list
-    h_scalars.reserve(n * m);
-    h_scalars.resize(n * m);
-    for (std::size_t i = 0; i < n * m; i++) {
-        h_scalars[i] = Scalar(uint64_t(0));
-    }
     commit_scalars.reserve(commits.size());
     commit_scalars.resize(commits.size());
     for (size_t i = 0; i < commits.size(); i++) {
         commit_scalars[i] = Scalar(uint64_t(0));
     }
 
-    // Set up the final batch elements
-    std::vector<GroupElement> points;
-    std::vector<Scalar> scalars;
-    std::size_t final_size = 3 + m * n + commits.size(); // g, h1, h2, (h_), (commits)
+    // Set up the final batch elements, common generators are added once at the end
+    std::size_t final_size = points.size() + 3 + m * n + commits.size(); // g, h1, h2, (h_), (commits)
     for (std::size_t t = 0; t < M; t++) {
         final_size += 4 + proofs[t].Gk_.size() + proofs[t].Qk.size(); // A, B, C, D, (G), (Q)
     }
@@ -289,6 +361,36 @@ bool SigmaExtendedVerifier::verify(
         }
     }
 
+    for (std::size_t i = 0; i < commits.size(); i++) {
+        points.emplace_back(commits[i]);
+        scalars.emplace_back(commit_scalars[i]);
+    }
+    return true;
+}
+
+// Add common generators and check the final multiexponentiation
+bool SigmaExtendedVerifier::verify_batch(
+        const Scalar& g_scalar,
+        const Scalar& h1_scalar,
+        const Scalar& h2_scalar,
+        const std::vector<Scalar>& h_scalars,
+        std::vector<GroupElement>& points,
+        std::vector<Scalar>& scalars) const {
+    // Use precomputed tables for common generators if available
+    if (fixedBases && fixedBases->size() == m * n + 1) {
+        std::vector<Scalar> fixedScalars;
+        fixedScalars.reserve(m * n + 1);
+        fixedScalars.emplace_back(g_scalar);
+        fixedScalars.insert(fixedScalars.end(), h_scalars.begin(), h_scalars.begin() + m * n);
+        fixedScalars[1] += h2_scalar;
+        fixedScalars[2] += h1_scalar;
+
+        GroupElement result = fixedBases->get_multiple(fixedScalars);
+        if (!points.empty())
+            result += secp_primitives::MultiExponent(points, scalars).get_multiple();
+        return result.isInfinity();
+    }
+
     // Add common generators
     points.emplace_back(g_);
     scalars.emplace_back(g_scalar);
@@ -300,10 +402,6 @@ bool SigmaExtendedVerifier::verify(
         points.emplace_back(h_[i]);
         scalars.emplace_back(h_scalars[i]);
     }
-    for (std::size_t i = 0; i < commits.size(); i++) {
-        points.emplace_back(commits[i]);
-        scalars.emplace_back(commit_scalars[i]);
-    }
 
     // Verify the batch
     secp_primitives::MultiExponent result(points, scalars);
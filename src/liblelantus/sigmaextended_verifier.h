@@ -10,7 +10,8 @@ class SigmaExtendedVerifier{
 public:
     SigmaExtendedVerifier(const GroupElement& g,
                       const std::vector<GroupElement>& h_gens,
-                      std::size_t n_, std::size_t m_);
+                      std::size_t n_, std::size_t m_,
+                      const FixedBaseMultiExponent* fixedBases_ = nullptr);
 
     // Verify a single one-of-many proof
     // In this case, there is an implied input set size
@@ -41,6 +42,14 @@ public:
                      const std::vector<size_t>& setSizes,
                      const std::vector<SigmaExtendedProof>& proofs) const;
 
+    // Verify general batches of one-of-many proofs against several commitment sets at once
+    // In this case, terms of the common generators are computed only once for all the sets
+    bool batchverify_groups(const std::vector<const std::vector<GroupElement>*>& commits,
+                     const std::vector<std::vector<Scalar>>& challenges,
+                     const std::vector<std::vector<Scalar>>& serials,
+                     const std::vector<std::vector<size_t>>& setSizes,
+                     const std::vector<std::vector<SigmaExtendedProof>>& proofs) const;
+
 private:
     // Utility function that actually performs verification
     bool verify(const std::vector<GroupElement>& commits,
@@ -50,6 +59,28 @@ private:
                      const bool commonChallenge,
                      const bool specifiedSetSizes,
                      const std::vector<SigmaExtendedProof>& proofs) const;
+    // Adds verification equations of the batch against one commitment set,
+    // scalars of the common generators are accumulated into g_scalar, h1_scalar, h2_scalar and h_scalars
+    bool add_batch(const std::vector<GroupElement>& commits,
+                     const std::vector<Scalar>& challenges,
+                     const std::vector<Scalar>& serials,
+                     const std::vector<size_t>& setSizes,
+                     const bool commonChallenge,
+                     const bool specifiedSetSizes,
+                     const std::vector<SigmaExtendedProof>& proofs,
+                     Scalar& g_scalar,
+                     Scalar& h1_scalar,
+                     Scalar& h2_scalar,
+                     std::vector<Scalar>& h_scalars,
+                     std::vector<GroupElement>& points,
+                     std::vector<Scalar>& scalars) const;
+    // Adds the common generators and performs the final multiexponentiation
+    bool verify_batch(const Scalar& g_scalar,
+                     const Scalar& h1_scalar,
+                     const Scalar& h2_scalar,
+                     const std::vector<Scalar>& h_scalars,
+                     std::vector<GroupElement>& points,
+                     std::vector<Scalar>& scalars) const;
     //auxiliary functions
     bool membership_checks(const SigmaExtendedProof& proof) const;
     bool compute_fs(
@@ -79,6 +110,8 @@ private:
     std::vector<GroupElement> h_;
     std::size_t n;
     std::size_t m;
+    // optional precomputed tables for g followed by h_, have to be built from the same generators
+    const FixedBaseMultiExponent* fixedBases;
 };
 
 } // namespace lelantus
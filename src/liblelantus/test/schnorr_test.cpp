@@ -95,6 +95,50 @@ BOOST_AUTO_TEST_CASE(fake_prove_not_verify)
     BOOST_CHECK(!verifier.verify(y, a, b, fakeProof, challengeGenerator));
 }
 
+BOOST_AUTO_TEST_CASE(batch_verify)
+{
+    std::size_t proofsCount = 10;
+    SchnorrProver prover(g, h, true);
+    SchnorrVerifier verifier(g, h, true);
+
+    std::vector<GroupElement> ys(proofsCount);
+    std::vector<Scalar> challenges(proofsCount);
+    std::vector<SchnorrProof> proofs(proofsCount);
+    for (std::size_t i = 0; i < proofsCount; ++i) {
+        Scalar p, t;
+        p.randomize();
+        t.randomize();
+        ys[i] = LelantusPrimitives::commit(g, p, h, t);
+
+        std::unique_ptr<ChallengeGenerator> challengeGenerator = std::make_unique<ChallengeGeneratorImpl<CHash256>>(1);
+        prover.proof(p, t, ys[i], a, b, challengeGenerator, proofs[i]);
+
+        challengeGenerator.reset(new ChallengeGeneratorImpl<CHash256>(1));
+        verifier.get_challenge(ys[i], a, b, proofs[i], challengeGenerator, challenges[i]);
+    }
+
+    BOOST_CHECK(verifier.batch_verify(ys, challenges, proofs));
+    BOOST_CHECK(verifier.batch_verify({}, {}, {}));
+    BOOST_CHECK(!verifier.batch_verify(ys, challenges, std::vector<SchnorrProof>(proofs.begin(), proofs.end() - 1)));
+
+    // a single bad proof fails the whole batch
+    auto fakeProofs = proofs;
+    fakeProofs[proofsCount / 2].P1.randomize();
+    BOOST_CHECK(!verifier.batch_verify(ys, challenges, fakeProofs));
+
+    fakeProofs = proofs;
+    fakeProofs[proofsCount - 1].u.randomize();
+    BOOST_CHECK(!verifier.batch_verify(ys, challenges, fakeProofs));
+
+    auto fakeChallenges = challenges;
+    fakeChallenges[0].randomize();
+    BOOST_CHECK(!verifier.batch_verify(ys, fakeChallenges, proofs));
+
+    auto fakeYs = ys;
+    fakeYs[1].randomize();
+    BOOST_CHECK(!verifier.batch_verify(fakeYs, challenges, proofs));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace lelantus
\ No newline at end of file
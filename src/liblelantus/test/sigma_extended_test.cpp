@@ -233,6 +233,106 @@ BOOST_AUTO_TEST_CASE(one_out_of_N_batch_with_some_invalid_proof)
     BOOST_CHECK(!verifier.batchverify(commits, x, serials, proofs));
 }
 
+BOOST_AUTO_TEST_CASE(one_out_of_N_batch_several_groups)
+{
+    GenerateParams(16, 4);
+
+    Prover prover(g, h_gens, n, m);
+    Verifier verifier(g, h_gens, n, m);
+
+    std::vector<std::vector<GroupElement>> groupCommits;
+    std::vector<std::vector<Scalar>> challenges, serials;
+    std::vector<std::vector<std::size_t>> setSizes;
+    std::vector<std::vector<Proof>> proofs;
+
+    // groups of different sizes with different number of proofs
+    std::vector<std::vector<std::size_t>> indexes = {{1, 3}, {0}, {2, 5, 9}};
+    std::vector<std::size_t> groupSizes = {16, 12, 10};
+    for (std::size_t k = 0; k < indexes.size(); k++) {
+        auto commits = RandomizeGroupElements(groupSizes[k]);
+        std::vector<Secret> secrets;
+        for (auto index : indexes[k]) {
+            secrets.emplace_back(index);
+            auto &s = secrets.back();
+            commits[index] = Primitives::double_commit(
+                g, s.s, h_gens[1], s.v, h_gens[0], s.r);
+        }
+
+        challenges.emplace_back();
+        serials.emplace_back();
+        setSizes.emplace_back();
+        proofs.emplace_back();
+        for (auto const &s : secrets) {
+            Scalar x;
+            x.randomize();
+            proofs.back().emplace_back();
+            GenerateBatchProof(
+                prover, commits, s.l, s.s, s.v, s.r, x, proofs.back().back());
+            challenges.back().push_back(x);
+            serials.back().push_back(s.s);
+            setSizes.back().push_back(commits.size());
+        }
+        groupCommits.push_back(commits);
+    }
+
+    std::vector<const std::vector<GroupElement>*> commits;
+    for (auto const &c : groupCommits)
+        commits.push_back(&c);
+
+    BOOST_CHECK(verifier.batchverify_groups(commits, challenges, serials, setSizes, proofs));
+
+    // proof checked against wrong group should fail the whole batch
+    std::swap(commits[0], commits[1]);
+    BOOST_CHECK(!verifier.batchverify_groups(commits, challenges, serials, setSizes, proofs));
+    std::swap(commits[0], commits[1]);
+
+    // invalid serial in one group should fail the whole batch
+    serials[2][1].randomize();
+    BOOST_CHECK(!verifier.batchverify_groups(commits, challenges, serials, setSizes, proofs));
+}
+
+BOOST_AUTO_TEST_CASE(one_out_of_N_batch_fixed_bases)
+{
+    GenerateParams(16, 4);
+
+    std::vector<GroupElement> bases = {g};
+    bases.insert(bases.end(), h_gens.begin(), h_gens.end());
+    FixedBaseMultiExponent fixedBases(bases);
+
+    Prover prover(g, h_gens, n, m);
+    Verifier verifier(g, h_gens, n, m, &fixedBases);
+
+    std::size_t N = 16;
+    std::vector<std::size_t> indexes = {0, 3, 7};
+    auto commits = RandomizeGroupElements(N);
+    std::vector<Secret> secrets;
+    for (auto index : indexes) {
+        secrets.emplace_back(index);
+        auto &s = secrets.back();
+        commits[index] = Primitives::double_commit(
+            g, s.s, h_gens[1], s.v, h_gens[0], s.r);
+    }
+
+    std::vector<Scalar> challenges, serials;
+    std::vector<std::size_t> setSizes;
+    std::vector<Proof> proofs;
+    for (auto const &s : secrets) {
+        Scalar x;
+        x.randomize();
+        proofs.emplace_back();
+        GenerateBatchProof(
+            prover, commits, s.l, s.s, s.v, s.r, x, proofs.back());
+        challenges.push_back(x);
+        serials.push_back(s.s);
+        setSizes.push_back(N);
+    }
+
+    BOOST_CHECK(verifier.batchverify(commits, challenges, serials, setSizes, proofs));
+
+    serials[1].randomize();
+    BOOST_CHECK(!verifier.batchverify(commits, challenges, serials, setSizes, proofs));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace lelantus
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "../threadpool.h"
+
+#include <boost/test/unit_test.hpp>
+
+namespace lelantus {
+
+static int ParallelFib(int n) {
+    if (n < 2)
+        return n;
+
+    int a = 0, b = 0;
+    WorkStealingThreadPool::TaskGroup tasks;
+    tasks.Run([&]() { a = ParallelFib(n - 1); return true; });
+    tasks.Run([&]() { b = ParallelFib(n - 2); return true; });
+    tasks.Wait();
+    return a + b;
+}
+
+BOOST_AUTO_TEST_SUITE(lelantus_threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(all_tasks_run)
+{
+    std::atomic<int> counter{0};
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (int i = 0; i < 1000; i++)
+        tasks.Run([&counter]() { ++counter; return true; });
+
+    BOOST_CHECK(tasks.Wait());
+    BOOST_CHECK_EQUAL(counter, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(failure_is_reported)
+{
+    std::atomic<int> counter{0};
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (int i = 0; i < 100; i++)
+        tasks.Run([&counter, i]() { ++counter; return i != 50; });
+    tasks.Run([]() -> bool { throw std::runtime_error("task failed"); });
+
+    // a failed task doesn't cancel the others
+    BOOST_CHECK(!tasks.Wait());
+    BOOST_CHECK_EQUAL(counter, 100);
+}
+
+BOOST_AUTO_TEST_CASE(nested_groups)
+{
+    // every level waits for its children, waiting threads have to run queued tasks to avoid a deadlock
+    BOOST_CHECK_EQUAL(ParallelFib(16), 987);
+}
+
+BOOST_AUTO_TEST_CASE(chunks_cover_range)
+{
+    std::vector<int> visited(1001, 0);
+    BOOST_CHECK(ParallelForChunks(visited.size(), 64, [&visited](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+            visited[i]++;
+    }));
+    BOOST_CHECK(std::all_of(visited.begin(), visited.end(), [](int v) { return v == 1; }));
+}
+
+BOOST_AUTO_TEST_CASE(waiter_runs_own_group_only)
+{
+    WorkStealingThreadPool& pool = WorkStealingThreadPool::GetInstance();
+    std::size_t threads = pool.GetNumberOfThreads();
+    // without workers tasks are only run by the threads waiting for their groups
+    pool.SetNumberOfThreads(0);
+
+    std::atomic<int> other{0}, own{0};
+    WorkStealingThreadPool::TaskGroup otherTasks;
+    for (int i = 0; i < 10; i++)
+        otherTasks.Run([&other]() { ++other; return true; });
+
+    {
+        WorkStealingThreadPool::TaskGroup tasks;
+        for (int i = 0; i < 10; i++)
+            tasks.Run([&own]() { ++own; return true; });
+        BOOST_CHECK(tasks.Wait());
+    }
+    BOOST_CHECK_EQUAL(own, 10);
+    BOOST_CHECK_EQUAL(other, 0);
+
+    BOOST_CHECK(otherTasks.Wait());
+    BOOST_CHECK_EQUAL(other, 10);
+
+    pool.SetNumberOfThreads(threads);
+}
+
+BOOST_AUTO_TEST_CASE(change_number_of_threads)
+{
+    WorkStealingThreadPool& pool = WorkStealingThreadPool::GetInstance();
+    std::size_t threads = pool.GetNumberOfThreads();
+
+    for (std::size_t n : {0, 1, 3}) {
+        pool.SetNumberOfThreads(n);
+        BOOST_CHECK_EQUAL(pool.GetNumberOfThreads(), n);
+        BOOST_CHECK_EQUAL(ParallelFib(12), 144);
+    }
+
+    pool.SetNumberOfThreads(threads);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace lelantus
@@ -0,0 +1,191 @@
+#include "threadpool.h"
+
+// worker the current thread belongs to, used to push nested tasks to the own deque
+static thread_local const void* currentWorkerSet = nullptr;
+static thread_local std::size_t currentWorker = 0;
+
+WorkStealingThreadPool& WorkStealingThreadPool::GetInstance() {
+    static WorkStealingThreadPool instance;
+    return instance;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+    : numberOfThreads(std::max(boost::thread::hardware_concurrency(), 1u) - 1) {
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    Stop();
+}
+
+WorkStealingThreadPool::WorkerSet::WorkerSet(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+        workers.emplace_back(new Worker());
+}
+
+void WorkStealingThreadPool::SetNumberOfThreads(std::size_t n) {
+    Stop();
+
+    boost::mutex::scoped_lock lock(mutex);
+    // deques and threads are recreated with the next posted task, tickets left in the old deques
+    // are dropped and their tasks are run by the threads waiting for the groups
+    numberOfThreads = n;
+    workerSet.reset();
+    shutdown = false;
+}
+
+std::size_t WorkStealingThreadPool::GetNumberOfThreads() const {
+    return numberOfThreads;
+}
+
+void WorkStealingThreadPool::Stop() {
+    std::list<boost::thread> threadsToJoin;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        shutdown = true;
+        condition.notify_all();
+        threadsToJoin.swap(threads);
+    }
+
+    for (boost::thread& t : threadsToJoin)
+        t.join();
+}
+
+std::shared_ptr<WorkStealingThreadPool::WorkerSet> WorkStealingThreadPool::StartThreads() {
+    // should be called with mutex acquired
+    if (workerSet)
+        return workerSet;
+
+    // there is always at least one deque, with no threads tasks are run by waiting threads
+    workerSet = std::make_shared<WorkerSet>(std::max(numberOfThreads, std::size_t(1)));
+
+    if (!shutdown) {
+        for (std::size_t i = 0; i < numberOfThreads; ++i)
+            threads.emplace_back(std::bind(&WorkStealingThreadPool::ThreadProc, this, workerSet, i));
+    }
+    return workerSet;
+}
+
+void WorkStealingThreadPool::Push(Task task) {
+    boost::mutex::scoped_lock lock(mutex);
+    std::shared_ptr<WorkerSet> set = StartThreads();
+
+    std::size_t n = set->workers.size();
+    std::size_t index = (currentWorkerSet == set.get() && currentWorker < n) ? currentWorker : nextWorker++ % n;
+    {
+        boost::mutex::scoped_lock workerLock(set->workers[index]->mutex);
+        set->workers[index]->tasks.emplace_back(std::move(task));
+    }
+    ++set->queuedTasks;
+    condition.notify_one();
+}
+
+bool WorkStealingThreadPool::TryGetTask(WorkerSet& set, Task& task) {
+    std::size_t n = set.workers.size();
+    if (set.queuedTasks == 0)
+        return false;
+
+    std::size_t start = 0;
+    if (currentWorkerSet == &set && currentWorker < n) {
+        // newest task of our own deque first, it is most likely still in cache
+        Worker& self = *set.workers[currentWorker];
+        boost::mutex::scoped_lock lock(self.mutex);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            --set.queuedTasks;
+            return true;
+        }
+        start = currentWorker + 1;
+    }
+
+    // steal the oldest task of some other deque
+    for (std::size_t i = 0; i < n; ++i) {
+        Worker& victim = *set.workers[(start + i) % n];
+        boost::mutex::scoped_lock lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --set.queuedTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::ThreadProc(std::shared_ptr<WorkerSet> set, std::size_t index) {
+    currentWorkerSet = set.get();
+    currentWorker = index;
+
+    for (;;) {
+        Task task;
+        if (TryGetTask(*set, task)) {
+            task();
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        condition.wait(lock, [this, &set] { return set->queuedTasks > 0 || shutdown; });
+        if (shutdown)
+            break;
+    }
+}
+
+WorkStealingThreadPool::TaskGroup::TaskGroup(WorkStealingThreadPool& pool_) : pool(pool_), state(std::make_shared<State>()) {
+}
+
+WorkStealingThreadPool::TaskGroup::~TaskGroup() {
+    Wait();
+}
+
+void WorkStealingThreadPool::TaskGroup::State::RunNext() {
+    boost::unique_lock<boost::mutex> lock(mutex);
+    // the task was already taken by the waiter or another ticket
+    if (!tasks.empty())
+        Execute(lock);
+}
+
+void WorkStealingThreadPool::TaskGroup::State::Execute(boost::unique_lock<boost::mutex>& lock) {
+    std::function<bool()> task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+
+    bool fSuccess = false;
+    try {
+        fSuccess = task();
+    } catch (...) {
+    }
+
+    lock.lock();
+    if (!fSuccess)
+        failed = true;
+    if (--pending == 0)
+        condition.notify_all();
+}
+
+void WorkStealingThreadPool::TaskGroup::Run(std::function<bool()> task) {
+    {
+        boost::mutex::scoped_lock lock(state->mutex);
+        state->tasks.emplace_back(std::move(task));
+        ++state->pending;
+        // wakes up the waiter if the task is posted by a task of the same group
+        state->condition.notify_all();
+    }
+
+    std::shared_ptr<State> groupState = state;
+    pool.Push([groupState]() { groupState->RunNext(); });
+}
+
+bool WorkStealingThreadPool::TaskGroup::Wait() {
+    boost::unique_lock<boost::mutex> lock(state->mutex);
+    while (state->pending > 0) {
+        // help executing tasks of this group instead of blocking, tasks of other groups are left to workers
+        if (!state->tasks.empty()) {
+            state->Execute(lock);
+            continue;
+        }
+
+        // woken up when a running task finishes or a new one is posted to the group
+        state->condition.wait(lock);
+    }
+    return !state->failed;
+}
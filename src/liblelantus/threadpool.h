@@ -1,12 +1,14 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <list>
 #include <vector>
-//#include <algorithm>
 
 #define BOOST_THREAD_PROVIDES_FUTURE
 
@@ -113,6 +115,110 @@ public:
 };
 
 
+// Process-wide work-stealing thread pool shared by proof creation and verification code.
+// Every task group keeps its own queue of tasks, the pool queues a ticket per task which runs the next
+// task of its group. Every worker owns a deque of tickets: it pops its own from the back and steals from
+// the front of other workers' deques when idle. The thread waiting for a group runs tasks of that group
+// only, so nested fork/join never blocks a worker and a waiter never picks up unrelated work.
+class WorkStealingThreadPool {
+public:
+    class TaskGroup;
+
+    static WorkStealingThreadPool& GetInstance();
+
+    // Sets number of worker threads, the thread waiting for a task group also runs tasks of the group.
+    // Running workers are joined and restarted lazily, tasks of active groups are left to their waiters
+    void SetNumberOfThreads(std::size_t n);
+    std::size_t GetNumberOfThreads() const;
+
+    // Joins all workers, pending tasks are executed by the waiting threads
+    void Stop();
+
+    ~WorkStealingThreadPool();
+
+private:
+    typedef std::function<void()> Task;
+
+    struct Worker {
+        boost::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // deques of the started workers, replaced as a whole when the number of threads changes
+    struct WorkerSet {
+        explicit WorkerSet(std::size_t n);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<std::size_t> queuedTasks{0};
+    };
+
+    WorkStealingThreadPool();
+
+    // returns the current worker set, creates it and starts the threads if needed
+    std::shared_ptr<WorkerSet> StartThreads();
+    void Push(Task task);
+    // pops a ticket of the current worker or steals one from others
+    bool TryGetTask(WorkerSet& set, Task& task);
+    void ThreadProc(std::shared_ptr<WorkerSet> set, std::size_t index);
+
+    std::shared_ptr<WorkerSet> workerSet;
+    std::list<boost::thread> threads;
+    std::size_t numberOfThreads;
+    std::atomic<std::size_t> nextWorker{0};
+    bool shutdown{false};
+
+    boost::mutex mutex;
+    boost::condition_variable condition;
+};
+
+// Fork/join scope, all tasks posted through Run() are finished when Wait() returns
+class WorkStealingThreadPool::TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingThreadPool& pool = WorkStealingThreadPool::GetInstance());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // task returning false or throwing an exception marks the whole group as failed
+    void Run(std::function<bool()> task);
+
+    // runs tasks of the group which weren't started yet, returns false if any task of the group failed
+    bool Wait();
+
+private:
+    // shared with the tickets queued in the pool, they may outlive the group
+    struct State {
+        boost::mutex mutex;
+        boost::condition_variable condition;
+        std::deque<std::function<bool()>> tasks;
+        std::size_t pending{0};
+        bool failed{false};
+
+        // runs the next queued task of the group, if there is one
+        void RunNext();
+        // called with mutex acquired, releases it while the task runs
+        void Execute(boost::unique_lock<boost::mutex>& lock);
+    };
+
+    WorkStealingThreadPool& pool;
+    std::shared_ptr<State> state;
+};
+
+// Runs f(begin, end) for consecutive chunks of [0, size) in the shared pool, returns false if any call failed
+template <typename Function>
+bool ParallelForChunks(std::size_t size, std::size_t chunkSize, Function f) {
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (std::size_t begin = 0; begin < size; begin += chunkSize) {
+        std::size_t end = std::min(size, begin + chunkSize);
+        tasks.Run([&f, begin, end]() {
+            f(begin, end);
+            return true;
+        });
+    }
+    return tasks.Wait();
+}
+
 // helper class to put thread interruption on pause
 class DoNotDisturb {
 private:
@@ -122,4 +228,4 @@ public:
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -26,6 +26,7 @@ namespace llmq
 
 static const std::string DB_QUORUM_SK_SHARE = "q_Qsk";
 static const std::string DB_QUORUM_QUORUM_VVEC = "q_Qqvvec";
+static const std::string DB_QUORUM_PUBKEY_SHARES = "q_Qpkshares";
 
 CQuorumManager* quorumManager;
 
@@ -133,24 +134,70 @@ bool CQuorum::ReadContributions(CEvoDB& evoDb)
     return true;
 }
 
-void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
+void CQuorum::WritePubKeyShares(CEvoDB& evoDb) const
+{
+    uint256 dbKey = MakeQuorumKey(*this);
+
+    // shares of invalid members are written as invalid keys, so entries match members by index
+    std::vector<CBLSPublicKey> pubKeyShares;
+    pubKeyShares.reserve(members.size());
+    for (size_t i = 0; i < members.size(); i++) {
+        pubKeyShares.emplace_back(GetPubKeyShare(i));
+    }
+    evoDb.GetRawDB().Write(std::make_pair(DB_QUORUM_PUBKEY_SHARES, dbKey), pubKeyShares);
+}
+
+bool CQuorum::ReadPubKeyShares(CEvoDB& evoDb)
+{
+    uint256 dbKey = MakeQuorumKey(*this);
+
+    std::vector<CBLSPublicKey> pubKeyShares;
+    if (!evoDb.Read(std::make_pair(DB_QUORUM_PUBKEY_SHARES, dbKey), pubKeyShares) || pubKeyShares.size() != members.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < members.size(); i++) {
+        if (qc.validMembers[i] != pubKeyShares[i].IsValid()) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < members.size(); i++) {
+        if (qc.validMembers[i]) {
+            blsCache.AddPubKeyShare(members[i]->proTxHash, pubKeyShares[i]);
+        }
+    }
+    return true;
+}
+
+void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this, CEvoDB& evoDb)
 {
     if (_this->quorumVvec == nullptr) {
         return;
     }
 
+    if (_this->ReadPubKeyShares(evoDb)) {
+        LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- public key shares of quorum %s read from disk\n",
+                 _this->qc.quorumHash.ToString());
+        return;
+    }
+
     cxxtimer::Timer t(true);
     LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- start\n");
 
     // this thread will exit after some time
     // when then later some other thread tries to get keys, it will be much faster
-    _this->cachePopulatorThread = std::thread([_this, t]() {
+    _this->cachePopulatorThread = std::thread([_this, t, &evoDb]() {
         RenameThread("firo-q-cachepop");
-        for (size_t i = 0; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
+        size_t i = 0;
+        for (; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
             if (_this->qc.validMembers[i]) {
                 _this->GetPubKeyShare(i);
             }
         }
+        if (i == _this->members.size()) {
+            _this->WritePubKeyShares(evoDb);
+        }
         LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. time=%d\n", t.count());
     });
 }
@@ -253,7 +300,7 @@ bool CQuorumManager::BuildQuorumFromCommitment(const CFinalCommitment& qc, const
         // pre-populate caches in the background
         // recovering public key shares is quite expensive and would result in serious lags for the first few signing
         // sessions if the shares would be calculated on-demand
-        CQuorum::StartCachePopulatorThread(quorum);
+        CQuorum::StartCachePopulatorThread(quorum, evoDb);
     }
 
     return true;
@@ -88,6 +88,14 @@ CDKGMember::CDKGMember(CDeterministicMNCPtr _dmn, size_t _idx) :
 
 }
 
+CDKGSession::~CDKGSession()
+{
+    // the BLS worker still references the inputs of running verifications
+    for (auto& v : contributionVerifications) {
+        v.result.wait();
+    }
+}
+
 bool CDKGSession::Init(const CBlockIndex* _pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash)
 {
     if (mns.size() < params.minSize) {
@@ -338,16 +346,13 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 
     logger.Batch("decrypted our contribution share. time=%d", t2.count());
 
-    bool verifyPending = false;
     receivedSkContributions[member->idx] = skContribution;
     pendingContributionVerifications.emplace_back(member->idx);
     if (pendingContributionVerifications.size() >= 32) {
-        verifyPending = true;
-    }
-
-    if (verifyPending) {
-        VerifyPendingContributions();
+        // verified on the BLS worker while we continue to receive contributions
+        StartPendingContributionsVerification();
     }
+    ProcessContributionVerifications(false);
 }
 
 // Verifies all pending secret key contributions in one batch
@@ -355,53 +360,79 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
 // See CBLSWorker::VerifyContributionShares for more details.
+// Waits for the batches started before as well
 void CDKGSession::VerifyPendingContributions()
 {
-    CDKGLogger logger(*this, __func__);
-
-    cxxtimer::Timer t1(true);
+    StartPendingContributionsVerification();
+    ProcessContributionVerifications(true);
+}
 
+void CDKGSession::StartPendingContributionsVerification()
+{
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
     if (pend.empty()) {
         return;
     }
 
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
+    contributionVerifications.emplace_back();
+    auto& v = contributionVerifications.back();
+    v.nStartTime = GetTimeMillis();
 
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        v.memberIndexes.emplace_back(idx);
+        v.vvecs.emplace_back(receivedVvecs[idx]);
+        v.skContributions.emplace_back(receivedSkContributions[idx]);
     }
-
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    if (v.memberIndexes.empty()) {
+        contributionVerifications.pop_back();
         return;
     }
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+    // inputs are referenced until the result is ready, list elements don't move
+    v.result = blsWorker.AsyncVerifyContributionShares(myId, v.vvecs, v.skContributions, true, true);
+}
+
+// Handles the results of contribution verifications, either the finished ones or all of them
+void CDKGSession::ProcessContributionVerifications(bool fWait)
+{
+    CDKGLogger logger(*this, __func__);
+
+    for (auto it = contributionVerifications.begin(); it != contributionVerifications.end(); ) {
+        auto& v = *it;
+        if (!fWait && v.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
         }
-    }
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+        auto result = v.result.get();
+        if (result.size() != v.memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), v.memberIndexes.size());
+            it = contributionVerifications.erase(it);
+            continue;
+        }
+
+        for (size_t i = 0; i < v.memberIndexes.size(); i++) {
+            if (!result[i]) {
+                auto& m = members[v.memberIndexes[i]];
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.weComplain = true;
+                    return true;
+                });
+            } else {
+                size_t memberIdx = v.memberIndexes[i];
+                dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, v.skContributions[i]);
+            }
+        }
+
+        logger.Batch("verified %d pending contributions. time=%d", v.memberIndexes.size(), GetTimeMillis() - v.nStartTime);
+        it = contributionVerifications.erase(it);
+    }
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -16,6 +16,8 @@
 
 #include "llmq/quorums_utils.h"
 
+#include <list>
+
 class UniValue;
 
 namespace llmq
@@ -279,12 +281,23 @@ private:
 
     std::vector<size_t> pendingContributionVerifications;
 
+    // batches of contributions being verified by the BLS worker while further messages are received
+    struct ContributionVerification {
+        std::vector<size_t> memberIndexes;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        BLSSecretKeyVector skContributions;
+        std::future<std::vector<bool> > result;
+        int64_t nStartTime;
+    };
+    std::list<ContributionVerification> contributionVerifications;
+
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments;
 
 public:
     CDKGSession(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager) :
         params(_params), blsWorker(_blsWorker), cache(_blsWorker), dkgManager(_dkgManager) {}
+    ~CDKGSession();
 
     bool Init(const CBlockIndex* pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash);
 
@@ -309,6 +322,8 @@ public:
     bool PreVerifyMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan);
     void VerifyPendingContributions();
+    void StartPendingContributionsVerification();
+    void ProcessContributionVerifications(bool fWait);
 
     // Phase 2: complaint
     void VerifyAndComplain(CDKGPendingMessages& pendingMessages);
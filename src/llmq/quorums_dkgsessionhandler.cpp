@@ -9,6 +9,7 @@
 #include "quorums_utils.h"
 
 #include "activemasternode.h"
+#include "bls/bls_batchverifier.h"
 #include "chainparams.h"
 #include "init.h"
 #include "net_processing.h"
@@ -268,7 +269,7 @@ void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
 
 // returns a set of NodeIds which sent invalid messages
 template<typename Message>
-std::set<NodeId> BatchVerifyMessageSigs(CDKGSession& session, const std::vector<std::pair<NodeId, std::shared_ptr<Message>>>& messages)
+std::set<NodeId> BatchVerifyMessageSigs(CDKGSession& session, CBLSWorker& blsWorker, const std::vector<std::pair<NodeId, std::shared_ptr<Message>>>& messages)
 {
     if (messages.empty()) {
         return {};
@@ -346,23 +347,31 @@ std::set<NodeId> BatchVerifyMessageSigs(CDKGSession& session, const std::vector<
         // different nodes, let's figure out who are the bad ones
     }
 
-    for (const auto& p : messages) {
+    // bisect the messages on the BLS worker threads instead of verifying them one by one
+    CBLSBatchVerifier<NodeId, size_t> batchVerifier(false, false, 0, &blsWorker);
+    for (size_t i = 0; i < messages.size(); i++) {
+        const auto& p = messages[i];
         if (ret.count(p.first)) {
             continue;
         }
 
         const auto& msg = *p.second;
         auto member = session.GetMember(msg.proTxHash);
-        bool valid = msg.sig.VerifyInsecure(member->dmn->pdmnState->pubKeyOperator.Get(), msg.GetSignHash());
-        if (!valid) {
+        const CBLSPublicKey& pubKey = member->dmn->pdmnState->pubKeyOperator.Get();
+        if (!msg.sig.IsValid() || !pubKey.IsValid()) {
             ret.emplace(p.first);
+            continue;
         }
+        batchVerifier.PushMessage(p.first, i, msg.GetSignHash(), msg.sig, pubKey);
     }
+    batchVerifier.Verify();
+
+    ret.insert(batchVerifier.badSources.begin(), batchVerifier.badSources.end());
     return ret;
 }
 
 template<typename Message>
-bool ProcessPendingMessageBatch(CDKGSession& session, CDKGPendingMessages& pendingMessages, size_t maxCount)
+bool ProcessPendingMessageBatch(CDKGSession& session, CBLSWorker& blsWorker, CDKGPendingMessages& pendingMessages, size_t maxCount)
 {
     auto msgs = pendingMessages.PopAndDeserializeMessages<Message>(maxCount);
     if (msgs.empty()) {
@@ -410,7 +419,7 @@ bool ProcessPendingMessageBatch(CDKGSession& session, CDKGPendingMessages& pendi
         return true;
     }
 
-    auto badNodes = BatchVerifyMessageSigs(session, preverifiedMessages);
+    auto badNodes = BatchVerifyMessageSigs(session, blsWorker, preverifiedMessages);
     if (!badNodes.empty()) {
         LOCK(cs_main);
         for (auto nodeId : badNodes) {
@@ -508,7 +517,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->Contribute(pendingContributions);
     };
     auto fContributeWait = [this] {
-        return ProcessPendingMessageBatch<CDKGContribution>(*curSession, pendingContributions, 8);
+        return ProcessPendingMessageBatch<CDKGContribution>(*curSession, blsWorker, pendingContributions, 8);
     };
     HandlePhase(QuorumPhase_Contribute, QuorumPhase_Complain, curQuorumHash, 0.05, fContributeStart, fContributeWait);
 
@@ -517,7 +526,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndComplain(pendingComplaints);
     };
     auto fComplainWait = [this] {
-        return ProcessPendingMessageBatch<CDKGComplaint>(*curSession, pendingComplaints, 8);
+        return ProcessPendingMessageBatch<CDKGComplaint>(*curSession, blsWorker, pendingComplaints, 8);
     };
     HandlePhase(QuorumPhase_Complain, QuorumPhase_Justify, curQuorumHash, 0.05, fComplainStart, fComplainWait);
 
@@ -526,7 +535,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndJustify(pendingJustifications);
     };
     auto fJustifyWait = [this] {
-        return ProcessPendingMessageBatch<CDKGJustification>(*curSession, pendingJustifications, 8);
+        return ProcessPendingMessageBatch<CDKGJustification>(*curSession, blsWorker, pendingJustifications, 8);
     };
     HandlePhase(QuorumPhase_Justify, QuorumPhase_Commit, curQuorumHash, 0.05, fJustifyStart, fJustifyWait);
 
@@ -535,7 +544,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndCommit(pendingPrematureCommitments);
     };
     auto fCommitWait = [this] {
-        return ProcessPendingMessageBatch<CDKGPrematureCommitment>(*curSession, pendingPrematureCommitments, 8);
+        return ProcessPendingMessageBatch<CDKGPrematureCommitment>(*curSession, blsWorker, pendingPrematureCommitments, 8);
     };
     HandlePhase(QuorumPhase_Commit, QuorumPhase_Finalize, curQuorumHash, 0.1, fCommitStart, fCommitWait);
 
@@ -338,8 +338,9 @@ std::vector<uint256> CInstantSendDb::RemoveChainedInstantSendLocks(const uint256
 
 ////////////////
 
-CInstantSendManager::CInstantSendManager(CDBWrapper& _llmqDb) :
-    db(_llmqDb)
+CInstantSendManager::CInstantSendManager(CDBWrapper& _llmqDb, CBLSWorker& _blsWorker) :
+    db(_llmqDb),
+    blsWorker(_blsWorker)
 {
     workInterrupt.reset();
 }
@@ -809,7 +810,7 @@ std::unordered_set<uint256> CInstantSendManager::ProcessPendingInstantSendLocks(
 {
     auto llmqType = Params().GetConsensus().llmqForInstantSend;
 
-    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8);
+    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8, &blsWorker);
     std::unordered_map<uint256, std::pair<CQuorumCPtr, CRecoveredSig>> recSigs;
 
     for (const auto& p : pend) {
@@ -1547,7 +1548,7 @@ CTransaction AdaptJsplitTx(CTransaction const & tx)
     static size_t const jsplitSerialSize = 32;
 
     CTransaction result{tx};
-    std::unique_ptr <lelantus::JoinSplit> jsplit;
+    std::shared_ptr<const lelantus::JoinSplit> jsplit;
     try {
         jsplit = lelantus::ParseLelantusJoinSplit(tx);
     }
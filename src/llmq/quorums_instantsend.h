@@ -77,6 +77,7 @@ class CInstantSendManager : public CRecoveredSigsListener
 private:
     CCriticalSection cs;
     CInstantSendDb db;
+    CBLSWorker& blsWorker;
 
     std::thread workThread;
     CThreadInterrupt workInterrupt;
@@ -113,7 +114,7 @@ private:
     std::atomic_bool isNewInstantSendEnabled{false};
 
 public:
-    CInstantSendManager(CDBWrapper& _llmqDb);
+    CInstantSendManager(CDBWrapper& _llmqDb, CBLSWorker& _blsWorker);
     ~CInstantSendManager();
 
     void Start();
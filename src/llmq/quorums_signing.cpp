@@ -50,6 +50,63 @@ CRecoveredSigsDb::CRecoveredSigsDb(CDBWrapper& _db) :
 
         db.Write(std::string("rs_upgraded"), (uint8_t)1);
     }
+
+    LoadFilters();
+}
+
+bool CRecoveredSigsDb::MayHaveKey(const uint256& filterKey)
+{
+    auto& shard = GetShard(filterKey);
+    LOCK(shard.cs);
+    return !shard.fFilterComplete || shard.filter.contains(filterKey);
+}
+
+void CRecoveredSigsDb::AddFilterKey(const uint256& filterKey)
+{
+    auto& shard = GetShard(filterKey);
+    LOCK(shard.cs);
+    shard.filter.insert(filterKey);
+    if (++shard.nFilterKeys > SHARD_FILTER_ELEMENTS && shard.fFilterComplete) {
+        // the rolling filter may forget older keys from now on
+        LogPrint("llmq", "CRecoveredSigsDb::%s -- recovered sigs filter is full, falling back to db lookups\n", __func__);
+        shard.fFilterComplete = false;
+    }
+}
+
+// Fills the shard filters with the keys of the recovered sigs and votes in the db
+void CRecoveredSigsDb::LoadFilters()
+{
+    int64_t nStart = GetTimeMillis();
+    size_t cnt = 0;
+
+    auto loadKeys = [&](const std::string& prefix, auto start) {
+        std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+        pcursor->Seek(start);
+        while (pcursor->Valid()) {
+            decltype(start) k;
+            if (!pcursor->GetKey(k) || std::get<0>(k) != prefix) {
+                break;
+            }
+            // "rs_r" keys which include the msgHash are read back as the id key of the same recovered sig
+            AddFilterKey(GetFilterKey(k));
+            cnt++;
+            pcursor->Next();
+        }
+    };
+    loadKeys("rs_r", std::make_tuple(std::string("rs_r"), (uint8_t)0, uint256()));
+    loadKeys("rs_h", std::make_tuple(std::string("rs_h"), uint256()));
+    loadKeys("rs_s", std::make_tuple(std::string("rs_s"), uint256()));
+    loadKeys("rs_v", std::make_tuple(std::string("rs_v"), (uint8_t)0, uint256()));
+
+    size_t nComplete = 0;
+    for (auto& shard : shards) {
+        LOCK(shard.cs);
+        shard.fFilterComplete = shard.nFilterKeys <= SHARD_FILTER_ELEMENTS;
+        nComplete += shard.fFilterComplete ? 1 : 0;
+    }
+
+    LogPrintf("CRecoveredSigsDb::%s -- loaded %d keys into %d/%d complete filters, time=%d\n", __func__,
+        cnt, nComplete, SHARDS_COUNT, GetTimeMillis() - nStart);
 }
 
 // This converts time values in "rs_t" from host endiannes to big endiannes, which is required to have proper ordering of the keys
@@ -127,6 +184,10 @@ void CRecoveredSigsDb::AddVoteTimeKeys()
 
 bool CRecoveredSigsDb::HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
 {
+    if (!MayHaveKey(GetFilterKey(std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id)))) {
+        return false;
+    }
+
     auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id, msgHash);
     return db.Exists(k);
 }
@@ -134,56 +195,70 @@ bool CRecoveredSigsDb::HasRecoveredSig(Consensus::LLMQType llmqType, const uint2
 bool CRecoveredSigsDb::HasRecoveredSigForId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto cacheKey = std::make_pair(llmqType, id);
+    auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
+    uint256 filterKey = GetFilterKey(k);
+    auto& shard = GetShard(filterKey);
     bool ret;
     {
-        LOCK(cs);
-        if (hasSigForIdCache.get(cacheKey, ret)) {
+        LOCK(shard.cs);
+        if (shard.hasSigForIdCache.get(cacheKey, ret)) {
             return ret;
         }
+        if (shard.fFilterComplete && !shard.filter.contains(filterKey)) {
+            return false;
+        }
     }
 
-
-    auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
     ret = db.Exists(k);
 
-    LOCK(cs);
-    hasSigForIdCache.insert(cacheKey, ret);
+    LOCK(shard.cs);
+    shard.hasSigForIdCache.insert(cacheKey, ret);
     return ret;
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash)
 {
+    auto k = std::make_tuple(std::string("rs_s"), signHash);
+    uint256 filterKey = GetFilterKey(k);
+    auto& shard = GetShard(filterKey);
     bool ret;
     {
-        LOCK(cs);
-        if (hasSigForSessionCache.get(signHash, ret)) {
+        LOCK(shard.cs);
+        if (shard.hasSigForSessionCache.get(signHash, ret)) {
             return ret;
         }
+        if (shard.fFilterComplete && !shard.filter.contains(filterKey)) {
+            return false;
+        }
     }
 
-    auto k = std::make_tuple(std::string("rs_s"), signHash);
     ret = db.Exists(k);
 
-    LOCK(cs);
-    hasSigForSessionCache.insert(signHash, ret);
+    LOCK(shard.cs);
+    shard.hasSigForSessionCache.insert(signHash, ret);
     return ret;
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForHash(const uint256& hash)
 {
+    auto k = std::make_tuple(std::string("rs_h"), hash);
+    uint256 filterKey = GetFilterKey(k);
+    auto& shard = GetShard(filterKey);
     bool ret;
     {
-        LOCK(cs);
-        if (hasSigForHashCache.get(hash, ret)) {
+        LOCK(shard.cs);
+        if (shard.hasSigForHashCache.get(hash, ret)) {
             return ret;
         }
+        if (shard.fFilterComplete && !shard.filter.contains(filterKey)) {
+            return false;
+        }
     }
 
-    auto k = std::make_tuple(std::string("rs_h"), hash);
     ret = db.Exists(k);
 
-    LOCK(cs);
-    hasSigForHashCache.insert(hash, ret);
+    LOCK(shard.cs);
+    shard.hasSigForHashCache.insert(hash, ret);
     return ret;
 }
 
@@ -207,6 +282,9 @@ bool CRecoveredSigsDb::ReadRecoveredSig(Consensus::LLMQType llmqType, const uint
 bool CRecoveredSigsDb::GetRecoveredSigByHash(const uint256& hash, CRecoveredSig& ret)
 {
     auto k1 = std::make_tuple(std::string("rs_h"), hash);
+    if (!MayHaveKey(GetFilterKey(k1))) {
+        return false;
+    }
     std::pair<uint8_t, uint256> k2;
     if (!db.Read(k1, k2)) {
         return false;
@@ -217,6 +295,9 @@ bool CRecoveredSigsDb::GetRecoveredSigByHash(const uint256& hash, CRecoveredSig&
 
 bool CRecoveredSigsDb::GetRecoveredSigById(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret)
 {
+    if (!MayHaveKey(GetFilterKey(std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id)))) {
+        return false;
+    }
     return ReadRecoveredSig(llmqType, id, ret);
 }
 
@@ -247,22 +328,35 @@ void CRecoveredSigsDb::WriteRecoveredSig(const llmq::CRecoveredSig& recSig)
     auto k5 = std::make_tuple(std::string("rs_t"), (uint32_t)htobe32(curTime), recSig.llmqType, recSig.id);
     batch.Write(k5, (uint8_t)1);
 
+    // filters must know the keys before they can be found in the db
+    uint256 idFilterKey = GetFilterKey(k1);
+    uint256 sessionFilterKey = GetFilterKey(k4);
+    uint256 hashFilterKey = GetFilterKey(k3);
+    AddFilterKey(idFilterKey);
+    AddFilterKey(sessionFilterKey);
+    AddFilterKey(hashFilterKey);
+
     db.WriteBatch(batch);
 
     {
-        int64_t t = GetTimeMillis();
-
-        LOCK(cs);
-        hasSigForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), true);
-        hasSigForSessionCache.insert(signHash, true);
-        hasSigForHashCache.insert(recSig.GetHash(), true);
+        auto& shard = GetShard(idFilterKey);
+        LOCK(shard.cs);
+        shard.hasSigForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), true);
+    }
+    {
+        auto& shard = GetShard(sessionFilterKey);
+        LOCK(shard.cs);
+        shard.hasSigForSessionCache.insert(signHash, true);
+    }
+    {
+        auto& shard = GetShard(hashFilterKey);
+        LOCK(shard.cs);
+        shard.hasSigForHashCache.insert(recSig.GetHash(), true);
     }
 }
 
 void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteTimeKey)
 {
-    AssertLockHeld(cs);
-
     CRecoveredSig recSig;
     if (!ReadRecoveredSig(llmqType, id, recSig)) {
         return;
@@ -290,14 +384,26 @@ void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType l
         }
     }
 
-    hasSigForIdCache.erase(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id));
-    hasSigForSessionCache.erase(signHash);
-    hasSigForHashCache.erase(recSig.GetHash());
+    // keys stay in the filters, which only leads to a db lookup
+    {
+        auto& shard = GetShard(GetFilterKey(k1));
+        LOCK(shard.cs);
+        shard.hasSigForIdCache.erase(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id));
+    }
+    {
+        auto& shard = GetShard(GetFilterKey(k4));
+        LOCK(shard.cs);
+        shard.hasSigForSessionCache.erase(signHash);
+    }
+    {
+        auto& shard = GetShard(GetFilterKey(k3));
+        LOCK(shard.cs);
+        shard.hasSigForHashCache.erase(recSig.GetHash());
+    }
 }
 
 void CRecoveredSigsDb::RemoveRecoveredSig(Consensus::LLMQType llmqType, const uint256& id)
 {
-    LOCK(cs);
     CDBBatch batch(db);
     RemoveRecoveredSig(batch, llmqType, id, true);
     db.WriteBatch(batch);
@@ -336,15 +442,12 @@ void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
     }
 
     CDBBatch batch(db);
-    {
-        LOCK(cs);
-        for (auto& e : toDelete) {
-            RemoveRecoveredSig(batch, e.first, e.second, false);
+    for (auto& e : toDelete) {
+        RemoveRecoveredSig(batch, e.first, e.second, false);
 
-            if (batch.SizeEstimate() >= (1 << 24)) {
-                db.WriteBatch(batch);
-                batch.Clear();
-            }
+        if (batch.SizeEstimate() >= (1 << 24)) {
+            db.WriteBatch(batch);
+            batch.Clear();
         }
     }
 
@@ -360,12 +463,18 @@ void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
 bool CRecoveredSigsDb::HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto k = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
+    if (!MayHaveKey(GetFilterKey(k))) {
+        return false;
+    }
     return db.Exists(k);
 }
 
 bool CRecoveredSigsDb::GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet)
 {
     auto k = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
+    if (!MayHaveKey(GetFilterKey(k))) {
+        return false;
+    }
     return db.Read(k, msgHashRet);
 }
 
@@ -378,6 +487,7 @@ void CRecoveredSigsDb::WriteVoteForId(Consensus::LLMQType llmqType, const uint25
     batch.Write(k1, msgHash);
     batch.Write(k2, (uint8_t)1);
 
+    AddFilterKey(GetFilterKey(k1));
     db.WriteBatch(batch);
 }
 
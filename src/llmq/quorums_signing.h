@@ -12,7 +12,9 @@
 #include "saltedhasher.h"
 #include "univalue.h"
 #include "unordered_lru_cache.h"
+#include "bloom.h"
 
+#include <array>
 #include <unordered_map>
 
 namespace llmq
@@ -64,12 +66,27 @@ public:
 class CRecoveredSigsDb
 {
 private:
+    static const size_t SHARDS_COUNT = 16;
+    // number of db keys every shard filter is guaranteed to remember
+    static const unsigned int SHARD_FILTER_ELEMENTS = 30000;
+
+    // Lookups are spread over shards, so the sig share, InstantSend and ChainLock threads don't contend for one lock.
+    // Every shard has a bloom filter of the hashes of the recovered sig and vote keys in the db, unknown ids are
+    // rejected without reading the db as long as the filter didn't overflow.
+    struct Shard {
+        CCriticalSection cs;
+        unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, bool, StaticSaltedHasher, 2048> hasSigForIdCache;
+        unordered_lru_cache<uint256, bool, StaticSaltedHasher, 2048> hasSigForSessionCache;
+        unordered_lru_cache<uint256, bool, StaticSaltedHasher, 2048> hasSigForHashCache;
+
+        CRollingBloomFilter filter{SHARD_FILTER_ELEMENTS, 0.001};
+        unsigned int nFilterKeys{0};
+        bool fFilterComplete{false};
+    };
+
     CDBWrapper& db;
 
-    CCriticalSection cs;
-    unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, bool, StaticSaltedHasher, 30000> hasSigForIdCache;
-    unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForSessionCache;
-    unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForHashCache;
+    std::array<Shard, SHARDS_COUNT> shards;
 
 public:
     CRecoveredSigsDb(CDBWrapper& _db);
@@ -98,6 +115,14 @@ public:
 private:
     bool ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret);
     void RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteTimeKey);
+
+    template <typename K>
+    static uint256 GetFilterKey(const K& dbKey) { return ::SerializeHash(dbKey); }
+    Shard& GetShard(const uint256& filterKey) { return shards[filterKey.GetCheapHash() % SHARDS_COUNT]; }
+    // false if the key is certainly not in the db
+    bool MayHaveKey(const uint256& filterKey);
+    void AddFilterKey(const uint256& filterKey);
+    void LoadFilters();
 };
 
 class CRecoveredSigsListener
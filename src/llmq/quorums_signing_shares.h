@@ -343,6 +343,9 @@ class CSigSharesManager : public CRecoveredSigsListener
 private:
     CCriticalSection cs;
 
+    // batch verification of incoming sig shares is spread over the worker threads
+    CBLSWorker& blsWorker;
+
     std::thread workThread;
     CThreadInterrupt workInterrupt;
 
@@ -364,7 +367,7 @@ private:
     std::atomic<uint32_t> recoveredSigsCounter{0};
 
 public:
-    CSigSharesManager();
+    CSigSharesManager(CBLSWorker& _blsWorker);
     ~CSigSharesManager();
 
     void StartWorkerThread();
@@ -211,6 +211,9 @@ struct CNodeState {
      * otherwise: whether this peer sends non-witnesses in cmpctblocks/blocktxns.
      */
     bool fSupportsDesiredCmpctVersion;
+    //! Competing joinsplits of this peer kept for block reconstruction since nCompetingJoinSplitsSince
+    int nCompetingJoinSplits;
+    int64_t nCompetingJoinSplitsSince;
 
     CNodeState(CAddress addrIn, std::string addrNameIn) : address(addrIn), name(addrNameIn) {
         fCurrentlyConnected = false;
@@ -233,6 +236,8 @@ struct CNodeState {
         fHaveWitness = false;
         fWantsCmpctWitness = false;
         fSupportsDesiredCmpctVersion = false;
+        nCompetingJoinSplits = 0;
+        nCompetingJoinSplitsSince = 0;
     }
 };
 
@@ -625,6 +630,23 @@ void AddToCompactExtraTransactions(const CTransactionRef& tx)
     vExtraTxnForCompactIt = (vExtraTxnForCompactIt + 1) % max_extra_txn;
 }
 
+bool IsCompetingJoinSplit(const CTransaction& tx, const CValidationState& state)
+{
+    return tx.IsLelantusJoinSplit() && state.GetRejectReason() == "txn-mempool-conflict"
+            && state.GetDebugMessage() == "lelantus-serial-in-mempool" && GetTransactionWeight(tx) < MAX_LELANTUS_TX_WEIGHT;
+}
+
+// Competing joinsplits are kept unverified, a peer may only fill a few slots of the extra txn pool with them
+static bool AllowCompetingJoinSplit(CNodeState* nodestate) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    int64_t nNow = GetTime();
+    if (nNow - nodestate->nCompetingJoinSplitsSince > COMPETING_JOINSPLITS_INTERVAL) {
+        nodestate->nCompetingJoinSplitsSince = nNow;
+        nodestate->nCompetingJoinSplits = 0;
+    }
+    return nodestate->nCompetingJoinSplits++ < MAX_COMPETING_JOINSPLITS_PER_PEER;
+}
+
 bool AddOrphanTx(const CTransactionRef& tx, NodeId peer) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
 {
     const uint256& hash = tx->GetHash();
@@ -2193,7 +2215,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                 // See https://github.com/bitcoin/bitcoin/issues/8279 for details.
                 assert(recentRejects);
                 recentRejects->insert(tx.GetHash());
-                if (RecursiveDynamicUsage(*ptx) < 100000) {
+                if (RecursiveDynamicUsage(*ptx) < 100000
+                        || (IsCompetingJoinSplit(tx, state) && AllowCompetingJoinSplit(State(pfrom->GetId())))) {
                     AddToCompactExtraTransactions(ptx);
                 }
             } else if (tx.HasWitness() && RecursiveDynamicUsage(*ptx) < 100000) {
@@ -18,6 +18,19 @@ static const int64_t ORPHAN_TX_EXPIRE_INTERVAL = 5 * 60;
 /** Default number of orphan+recently-replaced txn to keep around for block reconstruction */
 static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
 
+/** Maximum number of competing joinsplits kept for block reconstruction per peer in COMPETING_JOINSPLITS_INTERVAL */
+static const int MAX_COMPETING_JOINSPLITS_PER_PEER = 10;
+/** Interval in seconds the competing joinsplits of a peer are counted over */
+static const int64_t COMPETING_JOINSPLITS_INTERVAL = 10 * 60;
+
+/**
+ * Joinsplit which lost a serial race against another joinsplit of our mempool, the miner may have picked it
+ * instead of ours. Such joinsplits are too large for the usual extra txn limit but are the most likely to be
+ * missing when a compact block spending the same coins is reconstructed. They are rejected before their proofs
+ * are verified, the block they are used for verifies them.
+ */
+bool IsCompetingJoinSplit(const CTransaction& tx, const CValidationState& state);
+
 /** Register with a network node to receive its signals */
 void RegisterNodeSignals(CNodeSignals& nodeSignals);
 /** Unregister a network node */
@@ -0,0 +1,115 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "proofcache.h"
+
+#include "chain.h"
+#include "crypto/common.h"
+#include "random.h"
+#include "util.h"
+
+#include "cuckoocache.h"
+#include <boost/thread.hpp>
+
+namespace {
+
+/**
+ * Entries are salted hashes, so they can be used as cuckoo cache hashes directly
+ */
+class ProofCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const uint256& key) const
+    {
+        static_assert(hash_select <8, "ProofCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, key.begin()+4*hash_select, 4);
+        return u;
+    }
+};
+
+class CProofCache
+{
+private:
+    typedef CuckooCache::cache<uint256, ProofCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_proofcache;
+
+public:
+    uint256 nonce;
+
+    CProofCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    bool Get(const uint256& entry, const bool erase)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_proofcache);
+        return setValid.contains(entry, erase);
+    }
+
+    void Set(uint256 entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_proofcache);
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        return setValid.setup_bytes(n);
+    }
+};
+
+static CProofCache proofCache;
+}
+
+CProofCacheEntry::CProofCacheEntry(const uint256& txHash)
+{
+    hasher.Write(proofCache.nonce.begin(), 32).Write(txHash.begin(), 32);
+}
+
+CProofCacheEntry& CProofCacheEntry::AddAnonymitySet(uint32_t groupId, const CBlockIndex* firstBlock, const CBlockIndex* lastBlock, bool fSkipBlacklisted)
+{
+    uint256 firstHash = firstBlock->GetBlockHash();
+    uint256 lastHash = lastBlock->GetBlockHash();
+    unsigned char id[4];
+    WriteLE32(id, groupId);
+    hasher.Write(id, sizeof(id)).Write(firstHash.begin(), 32).Write(lastHash.begin(), 32);
+    return AddFlag(fSkipBlacklisted);
+}
+
+CProofCacheEntry& CProofCacheEntry::AddFlag(bool flag)
+{
+    unsigned char value = flag ? 1 : 0;
+    hasher.Write(&value, 1);
+    return *this;
+}
+
+uint256 CProofCacheEntry::GetHash()
+{
+    uint256 entry;
+    hasher.Finalize(entry.begin());
+    return entry;
+}
+
+bool IsProofCached(const uint256& entry, bool erase)
+{
+    return proofCache.Get(entry, erase);
+}
+
+void AddProofToCache(const uint256& entry)
+{
+    proofCache.Set(entry);
+}
+
+void InitProofCache()
+{
+    // setup_bytes creates the minimum possible cache (2 elements) if -maxproofcachesize is set to zero
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, GetArg("-maxproofcachesize", DEFAULT_MAX_PROOF_CACHE_SIZE)), MAX_MAX_PROOF_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = proofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
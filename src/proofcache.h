@@ -0,0 +1,51 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FIRO_PROOFCACHE_H
+#define FIRO_PROOFCACHE_H
+
+#include "crypto/sha256.h"
+#include "uint256.h"
+
+#include <cstdint>
+
+class CBlockIndex;
+
+// Default size of the cache of verified lelantus joinsplit proofs, in MiB (over 250000 entries)
+static const unsigned int DEFAULT_MAX_PROOF_CACHE_SIZE = 8;
+// Maximum proof cache size allowed
+static const int64_t MAX_MAX_PROOF_CACHE_SIZE = 1024;
+
+/**
+ * Key of the proof cache. Entries are SHA256(nonce || transaction hash || anonymity sets), every anonymity set
+ * the proofs were checked against is identified by its coin group, its first and last block and flags changing
+ * its content, so a proof verified against one chain state is never accepted against a different one.
+ */
+class CProofCacheEntry
+{
+public:
+    explicit CProofCacheEntry(const uint256& txHash);
+
+    CProofCacheEntry& AddAnonymitySet(uint32_t groupId, const CBlockIndex* firstBlock, const CBlockIndex* lastBlock, bool fSkipBlacklisted);
+    // binds the entry to other state the verification depends on
+    CProofCacheEntry& AddFlag(bool flag);
+
+    uint256 GetHash();
+
+private:
+    CSHA256 hasher;
+};
+
+/**
+ * Verified proof cache, to avoid verifying lelantus joinsplits twice, once when accepted into memory pool
+ * and again when accepted into the block chain. Sigma spends are not cached as they aren't accepted
+ * into memory pool anymore
+ */
+bool IsProofCached(const uint256& entry, bool erase);
+void AddProofToCache(const uint256& entry);
+
+// To be called once in AppInitMain/TestingSetup to initialize the proof cache
+void InitProofCache();
+
+#endif // FIRO_PROOFCACHE_H
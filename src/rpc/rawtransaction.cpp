@@ -123,7 +123,7 @@ void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry)
         } else if (txin.IsLelantusJoinSplit()) {
             in.push_back("joinsplit");
             fillStdFields(in, txin);
-            std::unique_ptr <lelantus::JoinSplit> jsplit;
+            std::shared_ptr<const lelantus::JoinSplit> jsplit;
             try {
                 jsplit = lelantus::ParseLelantusJoinSplit(tx);
             }
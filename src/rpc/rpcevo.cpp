@@ -1092,6 +1092,56 @@ UniValue protx_diff(const JSONRPCRequest& request)
     return ret;
 }
 
+void protx_cacheinfo_help()
+{
+    throw std::runtime_error(
+            "protx cacheinfo\n"
+            "\nReturns statistics of the deterministic znode list cache.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"entries\": n,              (numeric) Number of cached znode lists\n"
+            "  \"memoryUsage\": n,          (numeric) Estimated memory held by cached lists, in bytes\n"
+            "  \"maxMemoryUsage\": n,       (numeric) Memory limit of the cache, in bytes\n"
+            "  \"hits\": n,                 (numeric) Lookups answered from the cache\n"
+            "  \"misses\": n,               (numeric) Lookups which read a snapshot or replayed diffs\n"
+            "  \"hitRate\": x.xxx,          (numeric) Fraction of lookups answered from the cache\n"
+            "  \"snapshotsRead\": n,        (numeric) Snapshots read from disk\n"
+            "  \"diffsApplied\": n,         (numeric) Diffs replayed in total\n"
+            "  \"lastDiffDepth\": n,        (numeric) Diffs replayed by the last lookup\n"
+            "  \"maxDiffDepth\": n,         (numeric) Diffs replayed by the deepest lookup\n"
+            "  \"evictions\": n,            (numeric) Lists evicted to stay within the memory limit\n"
+            "  \"snapshotPeriod\": n        (numeric) Number of blocks between snapshots written to disk\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("protx", "cacheinfo")
+    );
+}
+
+UniValue protx_cacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        protx_cacheinfo_help();
+    }
+
+    CDeterministicMNListsCacheStats stats = deterministicMNManager->GetCacheStats();
+    uint64_t nLookups = stats.nHits + stats.nMisses;
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("entries", (uint64_t)stats.nEntries));
+    ret.push_back(Pair("memoryUsage", (uint64_t)stats.nMemoryUsage));
+    ret.push_back(Pair("maxMemoryUsage", (uint64_t)stats.nMaxMemoryUsage));
+    ret.push_back(Pair("hits", stats.nHits));
+    ret.push_back(Pair("misses", stats.nMisses));
+    ret.push_back(Pair("hitRate", nLookups ? (double)stats.nHits / nLookups : 0.0));
+    ret.push_back(Pair("snapshotsRead", stats.nSnapshotsRead));
+    ret.push_back(Pair("diffsApplied", stats.nDiffsApplied));
+    ret.push_back(Pair("lastDiffDepth", stats.nLastDiffDepth));
+    ret.push_back(Pair("maxDiffDepth", stats.nMaxDiffDepth));
+    ret.push_back(Pair("evictions", stats.nEvictions));
+    ret.push_back(Pair("snapshotPeriod", stats.nSnapshotPeriod));
+    return ret;
+}
+
 [[ noreturn ]] void protx_help()
 {
     throw std::runtime_error(
@@ -1115,6 +1165,7 @@ UniValue protx_diff(const JSONRPCRequest& request)
             "  revoke            - Create and send ProUpRevTx to network\n"
 #endif
             "  diff              - Calculate a diff and a proof between two znode lists\n"
+            "  cacheinfo         - Return statistics of the znode list cache\n"
     );
 }
 
@@ -1148,6 +1199,8 @@ UniValue protx(const JSONRPCRequest& request)
         return protx_info(request);
     } else if (command == "diff") {
         return protx_diff(request);
+    } else if (command == "cacheinfo") {
+        return protx_cacheinfo(request);
     } else {
         protx_help();
     }
@@ -21,15 +21,13 @@ public:
 
   GroupElement();
 
-  ~GroupElement();
-
-  GroupElement(const GroupElement& other);
+  GroupElement(const GroupElement& other) = default;
 
   GroupElement(const char* x,const char* y,  int base = 10);
 
   GroupElement& set(const GroupElement& other);
 
-  GroupElement& operator=(const GroupElement& other);
+  GroupElement& operator=(const GroupElement& other) = default;
 
   // Operator for multiplying with a scalar number.
   GroupElement operator*(const Scalar& multiplier) const;
@@ -109,7 +107,12 @@ public:
 
   GroupElement& set_base_g();
 
+  // Converts all the elements to affine coordinates sharing a single field inversion,
+  // affine elements are serialized and compared without inversions
+  static void normalize(std::vector<GroupElement>& elements);
+
   friend class MultiExponent;
+  friend class FixedBaseMultiExponent;
 private:
     // Returns the secp object inside it.
     const void * get_value() const;
@@ -117,7 +120,16 @@ private:
     GroupElement(const void *g);
 
 private:
-    void *g_; // secp256k1_gej
+    // size of secp256k1_gej, field elements of VERIFY builds also keep their magnitude and normalization flag,
+    // the value is checked against the actual field implementation in GroupElement.cpp
+#ifdef VERIFY
+    static constexpr std::size_t gej_size = 152;
+#else
+    static constexpr std::size_t gej_size = 128;
+#endif
+
+    // secp256k1_gej is kept inline so copying elements and vectors of them needs no heap allocations
+    alignas(8) unsigned char g_[gej_size];
 
 };
 
@@ -21,6 +21,35 @@ private:
     int n_points;
 };
 
+// Multiexponentiation with a fixed list of bases, used for protocol generators which are the same in every proof.
+// For every base all signed multiples of every window are precomputed once,
+// so computing the multiple needs only one point addition per nonzero window and no doublings.
+class FixedBaseMultiExponent {
+public:
+    FixedBaseMultiExponent(const std::vector<GroupElement>& bases, int window = DEFAULT_WINDOW);
+    ~FixedBaseMultiExponent();
+
+    FixedBaseMultiExponent(const FixedBaseMultiExponent& other) = delete;
+    FixedBaseMultiExponent& operator=(const FixedBaseMultiExponent& other) = delete;
+
+    // Returns sum of bases[offset + i] * powers[i]
+    GroupElement get_multiple(const std::vector<Scalar>& powers, std::size_t offset = 0) const;
+
+    std::size_t size() const { return n_bases; }
+
+    // memory used by precomputed tables in bytes
+    std::size_t memory_usage() const;
+
+public:
+    static constexpr int DEFAULT_WINDOW = 6;
+
+private:
+    void  *table_; // secp256k1_ge_storage[n_bases][n_windows][2^(window-1)]
+    std::size_t n_bases;
+    int window;
+    int n_windows;
+};
+
 }// namespace secp_primitives
 
 #endif //SECP_MULTIEXPONENT_H
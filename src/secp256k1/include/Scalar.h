@@ -21,15 +21,13 @@ public:
     Scalar(uint64_t value);
 
     // Copy constructor
-    Scalar(const Scalar& other);
+    Scalar(const Scalar& other) = default;
 
     Scalar(const unsigned char* str);
 
-    ~Scalar();
-
     Scalar& set(const Scalar& other);
 
-    Scalar& operator=(const Scalar& other);
+    Scalar& operator=(const Scalar& other) = default;
 
     Scalar& operator=(unsigned int i);
 
@@ -120,7 +118,8 @@ private:
     Scalar(const void *value);
 
 private:
-    void *value_; // secp256k1_scalar
+    // secp256k1_scalar kept inline, checked in Scalar.cpp
+    alignas(8) unsigned char value_[32];
 
 };
 
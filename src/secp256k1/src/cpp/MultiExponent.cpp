@@ -12,6 +12,9 @@
 #include "../src/scratch_impl.h"
 #include "../src/ecmult_impl.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 
 typedef struct {
     secp256k1_scalar *sc;
@@ -81,4 +84,95 @@ GroupElement MultiExponent::get_multiple() {
     return  reinterpret_cast<secp256k1_scalar *>(&r);
 }
 
+FixedBaseMultiExponent::FixedBaseMultiExponent(const std::vector<GroupElement>& bases, int window_)
+        : table_(NULL)
+        , n_bases(bases.size())
+        , window(window_)
+{
+    if (window < 2 || window > 16)
+        throw std::invalid_argument("Invalid window size for fixed base multiexponentiation");
+
+    // signed digits may carry into one extra window
+    n_windows = (256 + window - 1) / window + 1;
+    std::size_t n_multiples = std::size_t(1) << (window - 1);
+    std::size_t per_base = n_windows * n_multiples;
+
+    secp256k1_ge_storage *table = new secp256k1_ge_storage[n_bases * per_base];
+    table_ = table;
+
+    std::vector<secp256k1_gej> multiples_j(per_base);
+    std::vector<secp256k1_ge> multiples(per_base);
+    for (std::size_t i = 0; i < n_bases; ++i) {
+        // base * 2^(window * j)
+        secp256k1_gej base = *reinterpret_cast<const secp256k1_gej *>(bases[i].get_value());
+        for (int j = 0; j < n_windows; ++j) {
+            secp256k1_gej *row = &multiples_j[j * n_multiples];
+            row[0] = base;
+            for (std::size_t k = 1; k < n_multiples; ++k)
+                secp256k1_gej_add_var(&row[k], &row[k - 1], &base, NULL);
+
+            for (int d = 0; d < window; ++d)
+                secp256k1_gej_double_var(&base, &base, NULL);
+        }
+
+        // single inversion for all the multiples of the base
+        secp256k1_ge_set_all_gej_var(multiples.data(), multiples_j.data(), per_base, NULL);
+        for (std::size_t k = 0; k < per_base; ++k)
+            secp256k1_ge_to_storage(&table[i * per_base + k], &multiples[k]);
+    }
+}
+
+FixedBaseMultiExponent::~FixedBaseMultiExponent(){
+    delete []reinterpret_cast<secp256k1_ge_storage *>(table_);
+}
+
+std::size_t FixedBaseMultiExponent::memory_usage() const {
+    return n_bases * n_windows * (std::size_t(1) << (window - 1)) * sizeof(secp256k1_ge_storage);
+}
+
+GroupElement FixedBaseMultiExponent::get_multiple(const std::vector<Scalar>& powers, std::size_t offset) const {
+    if (offset + powers.size() > n_bases)
+        throw std::invalid_argument("Too many powers for fixed base multiexponentiation");
+
+    const secp256k1_ge_storage *table = reinterpret_cast<const secp256k1_ge_storage *>(table_);
+    std::size_t n_multiples = std::size_t(1) << (window - 1);
+    std::size_t per_base = n_windows * n_multiples;
+
+    secp256k1_gej r;
+    secp256k1_gej_set_infinity(&r);
+    secp256k1_ge add;
+    for (std::size_t i = 0; i < powers.size(); ++i) {
+        const secp256k1_scalar *s = reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
+        if (secp256k1_scalar_is_zero(s))
+            continue;
+
+        const secp256k1_ge_storage *base_table = &table[(offset + i) * per_base];
+        // recode the scalar into signed digits in [-2^(w-1), 2^(w-1)]
+        int carry = 0;
+        for (int j = 0; j < n_windows; ++j) {
+            int bit = j * window;
+            int digit = carry;
+            if (bit < 256)
+                digit += secp256k1_scalar_get_bits_var(s, bit, std::min(window, 256 - bit));
+            carry = 0;
+            if (digit > (1 << (window - 1))) {
+                digit -= (1 << window);
+                carry = 1;
+            }
+
+            if (digit == 0)
+                continue;
+            if (digit > 0) {
+                secp256k1_ge_from_storage(&add, &base_table[j * n_multiples + digit - 1]);
+            } else {
+                secp256k1_ge_from_storage(&add, &base_table[j * n_multiples - digit - 1]);
+                secp256k1_ge_neg(&add, &add);
+            }
+            secp256k1_gej_add_ge_var(&r, &r, &add, NULL);
+        }
+    }
+
+    return reinterpret_cast<secp256k1_scalar *>(&r);
+}
+
 }// namespace secp_primitives
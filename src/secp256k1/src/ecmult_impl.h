@@ -807,6 +807,8 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_ecmult_context *ctx,
     secp256k1_scalar *scalars;
     secp256k1_gej *buckets;
     struct secp256k1_pippenger_state *state_space;
+    secp256k1_gej *gej_points;
+    secp256k1_ge *ge_points;
     size_t idx = 0;
     size_t point_idx = 0;
     int i, j;
@@ -839,20 +841,35 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_ecmult_context *ctx,
 #endif
     }
 
+    /* Points are converted to affine coordinates all at once, sharing a single field inversion */
+    gej_points = (secp256k1_gej *) checked_malloc(scratch->error_callback, n_points * sizeof(*gej_points));
+    ge_points = (secp256k1_ge *) checked_malloc(scratch->error_callback, n_points * sizeof(*ge_points));
     while (point_idx < n_points) {
-        secp256k1_gej point;
-        if (!cb(&scalars[idx], &point, point_idx + cb_offset, cbdata)) {
+#ifdef USE_ENDOMORPHISM
+        secp256k1_scalar *sc = &scalars[idx + 2 * point_idx];
+#else
+        secp256k1_scalar *sc = &scalars[idx + point_idx];
+#endif
+        if (!cb(sc, &gej_points[point_idx], point_idx + cb_offset, cbdata)) {
+            free(gej_points);
+            free(ge_points);
             secp256k1_scratch_deallocate_frame(scratch);
             return 0;
         }
-        secp256k1_ge_set_gej(&points[idx], &point);
+        point_idx++;
+    }
+    secp256k1_ge_set_all_gej_var(ge_points, gej_points, n_points, scratch->error_callback);
+    free(gej_points);
+
+    for (point_idx = 0; point_idx < n_points; point_idx++) {
+        points[idx] = ge_points[point_idx];
         idx++;
 #ifdef USE_ENDOMORPHISM
         secp256k1_ecmult_endo_split(&scalars[idx - 1], &scalars[idx], &points[idx - 1], &points[idx]);
         idx++;
 #endif
-        point_idx++;
     }
+    free(ge_points);
 
     secp256k1_ecmult_pippenger_wnaf(buckets, bucket_window, state_space, r, scalars, points, idx);
 
@@ -199,7 +199,8 @@ bool CheckSigmaSpendTransaction(
 
     for (const CTxIn &txin : tx.vin)
     {
-        std::unique_ptr<sigma::CoinSpend> spend;
+        // shared with the verification task if the proof is verified in parallel
+        std::shared_ptr<sigma::CoinSpend> spend;
         uint32_t coinGroupId;
 
         vinIndex++;
@@ -271,6 +272,7 @@ bool CheckSigmaSpendTransaction(
         // This list of public coins is required by function "Verify" of CoinSpend.
         std::vector<sigma::PublicCoin> anonymity_set;
         while(true) {
+            LoadPrivacyPayload(index);
             if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
                 BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
                         index->sigmaMintedPubCoins[denominationAndId]) {
@@ -295,8 +297,24 @@ bool CheckSigmaSpendTransaction(
         }
 
         BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-        // if we are collecting proofs, skip verification and collect proofs
-        passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, batchProofContainer->fCollectProofs);
+        // proofs of the block being connected are verified on the thread pool, while serials
+        // are checked here in the order of transactions
+        bool fParallelCheck = !batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && sigmaTxInfo && !sigmaTxInfo->fInfoIsComplete
+                && batchProofContainer->isConnectingBlock();
+        if (fParallelCheck) {
+            auto sharedSet = std::make_shared<std::vector<sigma::PublicCoin>>(std::move(anonymity_set));
+            batchProofContainer->verifyInParallel([spend, sharedSet, newMetaData, fPadding, hashTx]() {
+                if (!spend->Verify(*sharedSet, newMetaData, fPadding)) {
+                    LogPrintf("CheckSigmaSpendTransaction: verification failed, tx=%s\n", hashTx.ToString());
+                    return false;
+                }
+                return true;
+            });
+            passVerify = true;
+        } else {
+            // if we are collecting proofs, skip verification and collect proofs
+            passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, batchProofContainer->fCollectProofs);
+        }
 
         // add proofs into container
         if(batchProofContainer->fCollectProofs) {
@@ -735,8 +753,9 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
-bool BuildSigmaStateFromIndex(CChain *chain) {
-    for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
+bool BuildSigmaStateFromIndex(CChain *chain, const CBlockIndex *pindexFrom) {
+    CBlockIndex *blockIndex = pindexFrom ? chain->Next(pindexFrom) : chain->Genesis();
+    for (; blockIndex; blockIndex=chain->Next(blockIndex))
     {
         sigmaState.AddBlock(blockIndex);
     }
@@ -828,6 +847,61 @@ void CSigmaState::Containers::Reset() {
     surgeCondition = false;
 }
 
+void CSigmaState::Containers::Dump(CAutoFile& file) const {
+    WriteCompactSize(file, mintedPubCoins.size());
+    for (const auto& mint : mintedPubCoins) {
+        file << mint.first << (int64_t)mint.second.denomination << mint.second.coinGroupId << mint.second.nHeight;
+    }
+    file << usedCoinSerials;
+
+    for (const metainfo_container_t* metaInfo : {&mintMetaInfo, &spendMetaInfo}) {
+        WriteCompactSize(file, metaInfo->size());
+        for (const auto& group : *metaInfo) {
+            file << group.first;
+            WriteCompactSize(file, group.second.size());
+            for (const auto& denom : group.second)
+                file << (int64_t)denom.first << (uint64_t)denom.second;
+        }
+    }
+    file << (bool)surgeCondition;
+}
+
+void CSigmaState::Containers::Load(CAutoFile& file) {
+    Reset();
+
+    uint64_t nMints = ReadCompactSize(file);
+    mintedPubCoins.reserve(nMints);
+    for (uint64_t i = 0; i < nMints; i++) {
+        sigma::PublicCoin pubCoin;
+        int64_t denomination;
+        CMintedCoinInfo coinInfo;
+        file >> pubCoin >> denomination >> coinInfo.coinGroupId >> coinInfo.nHeight;
+        coinInfo.denomination = CoinDenomination(denomination);
+        mintedPubCoins.emplace(pubCoin, coinInfo);
+    }
+    file >> usedCoinSerials;
+
+    for (metainfo_container_t* metaInfo : {&mintMetaInfo, &spendMetaInfo}) {
+        uint64_t nGroups = ReadCompactSize(file);
+        for (uint64_t i = 0; i < nGroups; i++) {
+            int groupId;
+            file >> groupId;
+            auto& denoms = (*metaInfo)[groupId];
+            uint64_t nDenoms = ReadCompactSize(file);
+            for (uint64_t j = 0; j < nDenoms; j++) {
+                int64_t denomination;
+                uint64_t count;
+                file >> denomination >> count;
+                denoms[CoinDenomination(denomination)] = count;
+            }
+        }
+    }
+
+    bool fSurgeCondition;
+    file >> fSurgeCondition;
+    surgeCondition = fSurgeCondition;
+}
+
 void CSigmaState::Containers::CheckSurgeCondition(int groupId, CoinDenomination denom) {
     bool result = spendMetaInfo[groupId][denom] > mintMetaInfo[groupId][denom];
     if( result ) {
@@ -914,6 +988,8 @@ void CSigmaState::AddSpend(const Scalar &serial, CoinDenomination denom, int coi
 }
 
 void CSigmaState::AddBlock(CBlockIndex *index) {
+    LoadPrivacyPayload(index);
+
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int), std::vector<sigma::PublicCoin>) &pubCoins,
             index->sigmaMintedPubCoins) {
@@ -940,6 +1016,8 @@ void CSigmaState::AddBlock(CBlockIndex *index) {
 }
 
 void CSigmaState::RemoveBlock(CBlockIndex *index) {
+    LoadPrivacyPayload(index);
+
     // roll back accumulator updates
     BOOST_FOREACH(
         const PAIRTYPE(PAIRTYPE(sigma::CoinDenomination, int),std::vector<sigma::PublicCoin>) &coin,
@@ -969,6 +1047,7 @@ void CSigmaState::RemoveBlock(CBlockIndex *index) {
             do {
                 assert(coinGroup.lastBlock != coinGroup.firstBlock);
                 coinGroup.lastBlock = coinGroup.lastBlock->pprev;
+                LoadPrivacyPayload(coinGroup.lastBlock);
             } while (coinGroup.lastBlock->sigmaMintedPubCoins.count(coin.first) == 0 ||
                         coinGroup.lastBlock->sigmaMintedPubCoins[coin.first].size() == 0);
         }
@@ -1045,6 +1124,7 @@ int CSigmaState::GetCoinSetForSpend(
         int coinGroupID,
         uint256& blockHash_out,
         std::vector<sigma::PublicCoin>& coins_out) {
+    LOCK(cs_main);
 
     coins_out.clear();
 
@@ -1059,6 +1139,7 @@ int CSigmaState::GetCoinSetForSpend(
     for (CBlockIndex *block = coinGroup.lastBlock;
             ;
             block = block->pprev) {
+        LoadPrivacyPayload(block);
         if (block->sigmaMintedPubCoins.count(denomAndId) > 0 &&
                 block->sigmaMintedPubCoins[denomAndId].size() > 0) {
             if (block->nHeight <= maxHeight) {
@@ -1091,6 +1172,8 @@ void CSigmaState::GetAnonymitySet(
         int coinGroupID,
         bool fStartSigmaBlacklist,
         std::vector<GroupElement>& coins_out) {
+    // reached from the background batch verification too, block payloads are loaded under cs_main
+    LOCK(cs_main);
 
     coins_out.clear();
 
@@ -1106,6 +1189,7 @@ void CSigmaState::GetAnonymitySet(
     for (CBlockIndex *block = coinGroup.lastBlock;
             ;
             block = block->pprev) {
+        LoadPrivacyPayload(block);
         if (block->sigmaMintedPubCoins.count(denomAndId) > 0 &&
                 block->sigmaMintedPubCoins[denomAndId].size() > 0) {
             if (block->nHeight <= maxHeight) {
@@ -1192,6 +1276,58 @@ void CSigmaState::Reset() {
     containers.Reset();
 }
 
+void CSigmaState::Dump(CAutoFile& file) const {
+    WriteCompactSize(file, coinGroups.size());
+    for (const auto& group : coinGroups) {
+        file << (int64_t)group.first.first << group.first.second;
+        file << (group.second.firstBlock ? group.second.firstBlock->GetBlockHash() : uint256());
+        file << (group.second.lastBlock ? group.second.lastBlock->GetBlockHash() : uint256());
+        file << group.second.nCoins;
+    }
+
+    WriteCompactSize(file, latestCoinIds.size());
+    for (const auto& id : latestCoinIds)
+        file << (int64_t)id.first << id.second;
+
+    containers.Dump(file);
+}
+
+void CSigmaState::Load(CAutoFile& file) {
+    Reset();
+
+    auto readBlockIndex = [&file]() -> CBlockIndex* {
+        uint256 hash;
+        file >> hash;
+        if (hash.IsNull())
+            return nullptr;
+        BlockMap::iterator it = mapBlockIndex.find(hash);
+        if (it == mapBlockIndex.end())
+            throw std::runtime_error("CSigmaState::Load: unknown block " + hash.ToString());
+        return it->second;
+    };
+
+    uint64_t nGroups = ReadCompactSize(file);
+    for (uint64_t i = 0; i < nGroups; i++) {
+        int64_t denomination;
+        int groupId;
+        file >> denomination >> groupId;
+        SigmaCoinGroupInfo& coinGroup = coinGroups[std::make_pair(CoinDenomination(denomination), groupId)];
+        coinGroup.firstBlock = readBlockIndex();
+        coinGroup.lastBlock = readBlockIndex();
+        file >> coinGroup.nCoins;
+    }
+
+    uint64_t nIds = ReadCompactSize(file);
+    for (uint64_t i = 0; i < nIds; i++) {
+        int64_t denomination;
+        int id;
+        file >> denomination >> id;
+        latestCoinIds[CoinDenomination(denomination)] = id;
+    }
+
+    containers.Load(file);
+}
+
 CSigmaState* CSigmaState::GetState() {
     return &sigmaState;
 }
@@ -89,7 +89,8 @@ bool GetOutPoint(COutPoint& outPoint, const sigma::PublicCoin &pubCoin);
 bool GetOutPoint(COutPoint& outPoint, const GroupElement &pubCoinValue);
 bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 
-bool BuildSigmaStateFromIndex(CChain *chain);
+// Add blocks of the chain to the state, starting after pindexFrom if the state was loaded up to it
+bool BuildSigmaStateFromIndex(CChain *chain, const CBlockIndex *pindexFrom = nullptr);
 
 Scalar GetSigmaSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
 CAmount GetSigmaSpendInput(const CTransaction &tx);
@@ -171,6 +172,10 @@ public:
     // Reset to initial values
     void Reset();
 
+    // Write the state to the file or read it back instead of adding every block at startup, throws on failure
+    void Dump(CAutoFile& file) const;
+    void Load(CAutoFile& file);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool CanAddSpendToMempool(const Scalar& coinSerial);
 
@@ -235,6 +240,9 @@ private:
 
         void Reset();
 
+        void Dump(CAutoFile& file) const;
+        void Load(CAutoFile& file);
+
         mint_info_container const & GetMints() const;
         spend_info_container const & GetSpends() const;
         bool IsSurgeCondition() const;
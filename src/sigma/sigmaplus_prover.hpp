@@ -1,6 +1,12 @@
 #include <math.h>
+
+#include "../liblelantus/threadpool.h"
+
 namespace sigma {
 
+// Anonymity set elements processed by a single task of the prover
+static const std::size_t SIGMA_PROVER_CHUNK_SIZE = 4096;
+
 template<class Exponent, class GroupElement>
 SigmaPlusProver<Exponent, GroupElement>::SigmaPlusProver(
         const GroupElement& g,
@@ -41,22 +47,11 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
     std::vector<Exponent> a;
     r1prover.proof(a, proof_out.r1Proof_, true /*Skip generation of final response*/);
 
-    // Compute coefficients of Polynomials P_I(x), for all I from [0..N].
+    // Coefficients of Polynomials P_I(x), for all I from [0..N], are computed along with G_k's below.
     std::size_t N = setSize;
-    std::vector <std::vector<Exponent>> P_i_k;
-    P_i_k.resize(N);
 
     // last polynomial is special case if fPadding is true
-    for (std::size_t i = 0; i < (fPadding ? N-1 : N); ++i) {
-        std::vector<Exponent>& coefficients = P_i_k[i];
-        std::vector<std::size_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n_, m_);
-        coefficients.push_back(a[I[0]]);
-        coefficients.push_back(sigma[I[0]]);
-        for (std::size_t j = 1; j < m_; ++j) {
-            SigmaPrimitives<Exponent, GroupElement>::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
-        }
-    }
-
+    std::vector<Exponent> p_i_sum;
     if (fPadding) {
         /*
          * To optimize calculation of sum of all polynomials indices 's' = setSize-1 through 'n^m-1' we use the
@@ -79,7 +74,6 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
         std::vector<std::size_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(N-1, n_, m_);
         std::vector<std::size_t> lj = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(l, n_, m_);
 
-        std::vector<Exponent> p_i_sum;
         p_i_sum.emplace_back(uint64_t(1));
         std::vector<std::vector<Exponent>> partial_p_s;
 
@@ -105,20 +99,62 @@ void SigmaPlusProver<Exponent, GroupElement>::proof(
                 p_i_sum[j + k] += polynomial[k];
         }
 
-        P_i_k[N-1] = p_i_sum;
     }
 
-    //computing G_k`s;
+    //computing G_k`s, the set is split into chunks processed in parallel, each of them adds its share to every G_k
+    std::size_t chunks = (N + SIGMA_PROVER_CHUNK_SIZE - 1) / SIGMA_PROVER_CHUNK_SIZE;
+    std::vector<std::vector<GroupElement>> partialGk(chunks);
+
+    DoNotDisturb dnd;
+    WorkStealingThreadPool::TaskGroup tasks;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        tasks.Run([&, chunk]() {
+            std::size_t begin = chunk * SIGMA_PROVER_CHUNK_SIZE;
+            std::size_t end = std::min(N, begin + SIGMA_PROVER_CHUNK_SIZE);
+
+            // P_i_k[k][i - begin] is the k-th coefficient of P_i(x)
+            std::vector<std::vector<Exponent>> P_i_k(m_);
+            for (auto& P_i : P_i_k)
+                P_i.reserve(end - begin);
+
+            std::vector<Exponent> coefficients;
+            coefficients.reserve(m_ + 1);
+            for (std::size_t i = begin; i < end; ++i) {
+                if (fPadding && i == N - 1) {
+                    coefficients = p_i_sum;
+                } else {
+                    std::vector<std::size_t> I = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n_, m_);
+                    coefficients.clear();
+                    coefficients.push_back(a[I[0]]);
+                    coefficients.push_back(sigma[I[0]]);
+                    for (std::size_t j = 1; j < m_; ++j) {
+                        SigmaPrimitives<Exponent, GroupElement>::new_factor(sigma[j * n_ + I[j]], a[j * n_ + I[j]], coefficients);
+                    }
+                }
+
+                for (std::size_t k = 0; k < m_; ++k)
+                    P_i_k[k].emplace_back(coefficients[k]);
+            }
+
+            std::vector<GroupElement> chunkCommits(commits.begin() + begin, commits.begin() + end);
+            partialGk[chunk].reserve(m_);
+            for (std::size_t k = 0; k < m_; ++k) {
+                secp_primitives::MultiExponent mult(chunkCommits, P_i_k[k]);
+                partialGk[chunk].emplace_back(mult.get_multiple());
+            }
+            return true;
+        });
+    }
+
+    if (!tasks.Wait())
+        throw std::runtime_error("Sigma proof creation failed.");
+
     std::vector <GroupElement> Gk;
     Gk.reserve(m_);
     for (std::size_t k = 0; k < m_; ++k) {
-        std::vector <Exponent> P_i;
-        P_i.reserve(N);
-        for (std::size_t i = 0; i < N; ++i) {
-            P_i.emplace_back(P_i_k[i][k]);
-        }
-        secp_primitives::MultiExponent mult(commits, P_i);
-        GroupElement c_k = mult.get_multiple();
+        GroupElement c_k;
+        for (const auto& chunkGk : partialGk)
+            c_k += chunkGk[k];
         c_k += SigmaPrimitives<Exponent, GroupElement>::commit(g_, Exponent(uint64_t(0)), h_[0], Pk[k]);
         Gk.emplace_back(c_k);
     }
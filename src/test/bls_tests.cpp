@@ -4,6 +4,7 @@
 
 #include "bls/bls.h"
 #include "bls/bls_batchverifier.h"
+#include "bls/bls_worker.h"
 #include "test/test_bitcoin.h"
 
 #include <boost/test/unit_test.hpp>
@@ -77,9 +78,9 @@ static void AddMessage(std::vector<Message>& vec, uint32_t sourceId, uint32_t ms
     vec.emplace_back(m);
 }
 
-static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback)
+static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback, CBLSWorker* worker = nullptr)
 {
-    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback);
+    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback, 0, worker);
 
     std::set<uint32_t> expectedBadMessages;
     std::set<uint32_t> expectedBadSources;
@@ -109,6 +110,15 @@ static void Verify(std::vector<Message>& vec)
     Verify(vec, true, false);
     Verify(vec, false, true);
     Verify(vec, true, true);
+
+    // sub-batches verified in parallel
+    CBLSWorker worker;
+    worker.Start();
+    Verify(vec, false, false, &worker);
+    Verify(vec, true, false, &worker);
+    Verify(vec, false, true, &worker);
+    Verify(vec, true, true, &worker);
+    worker.Stop();
 }
 
 BOOST_AUTO_TEST_CASE(batch_verifier_tests)
@@ -152,6 +162,13 @@ BOOST_AUTO_TEST_CASE(batch_verifier_tests)
     // last message invalid from one source
     AddMessage(msgs, 1, 7, 1, false);
     Verify(msgs);
+
+    msgs.clear();
+    // a few invalid messages among many sources, found by bisection
+    for (uint32_t i = 0; i < 40; i++) {
+        AddMessage(msgs, i / 2, i, i, i % 13 != 5);
+    }
+    Verify(msgs);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -13,6 +13,7 @@
 #include "messagesigner.h"
 #include "keystore.h"
 
+#include "evo/evodb.h"
 #include "evo/specialtx.h"
 #include "evo/providertx.h"
 #include "evo/deterministicmns.h"
@@ -408,4 +409,48 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
 
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
+
+BOOST_FIXTURE_TEST_CASE(dip3_mnlists_cache_limit, TestChainDIP3Setup)
+{
+    auto utxos = BuildSimpleUtxoMap(coinbaseTxns);
+
+    for (size_t i = 0; i < 6; i++) {
+        CKey ownerKey;
+        CBLSSecretKey operatorKey;
+        auto tx = CreateProRegTx(utxos, i + 1, GenerateRandomAddress(), coinbaseKey, ownerKey, operatorKey);
+        CreateAndProcessBlock({tx}, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    }
+    // lists of these blocks are derived from the previous ones without any change
+    for (size_t i = 0; i < 50; i++) {
+        CreateAndProcessBlock({}, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    }
+
+    // memory the nodes of the tip list take at least, every cached list keeps them alive
+    auto tipList = deterministicMNManager->GetListAtChainTip();
+    BOOST_CHECK_EQUAL(tipList.GetAllMNsCount(), 6U);
+    size_t nListMinUsage = sizeof(CDeterministicMNList) + tipList.GetAllMNsCount() * (sizeof(CDeterministicMN) + sizeof(CDeterministicMNState));
+
+    CDeterministicMNManager manager(*evoDb, 2 * nListMinUsage);
+    auto checkUsage = [&]() {
+        auto stats = manager.GetCacheStats();
+        BOOST_CHECK(stats.nEntries > 0);
+        // a single list is kept even if it exceeds the limit
+        BOOST_CHECK(stats.nEntries == 1 || stats.nMemoryUsage <= stats.nMaxMemoryUsage);
+        // evicting the base of the cached lists doesn't hide the nodes they share
+        BOOST_CHECK(stats.nMemoryUsage >= nListMinUsage);
+    };
+
+    LOCK(cs_main);
+    BOOST_CHECK(manager.GetListForBlock(chainActive.Tip()).GetAllMNsCount() == 6);
+    checkUsage();
+    BOOST_CHECK(manager.GetCacheStats().nEvictions > 0);
+
+    // lists of older blocks have to be rebuilt from the snapshot again
+    for (const CBlockIndex* pindex = chainActive.Tip()->pprev; pindex->nHeight > chainActive.Height() - 50; pindex = pindex->pprev) {
+        manager.GetListForBlock(pindex);
+        checkUsage();
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()
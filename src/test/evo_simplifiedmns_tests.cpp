@@ -4,7 +4,10 @@
 
 #include "test/test_bitcoin.h"
 
+#include "test/test_random.h"
+
 #include "bls/bls.h"
+#include "evo/deterministicmns.h"
 #include "evo/simplifiedmns.h"
 #include "netbase.h"
 
@@ -67,4 +70,82 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+static void AddTestMN(CDeterministicMNList& mnList)
+{
+    auto dmn = std::make_shared<CDeterministicMN>();
+    dmn->proTxHash = GetRandHash();
+    dmn->internalId = mnList.GetTotalRegisteredCount();
+    dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+    auto state = std::make_shared<CDeterministicMNState>();
+    state->keyIDOwner = CKeyID(uint160(std::vector<unsigned char>(dmn->proTxHash.begin(), dmn->proTxHash.begin() + 20)));
+    state->confirmedHash = GetRandHash();
+    dmn->pdmnState = state;
+
+    mnList.AddMN(dmn);
+    mnList.SetTotalRegisteredCount(mnList.GetTotalRegisteredCount() + 1);
+}
+
+static CDeterministicMNCPtr GetRandomTestMN(const CDeterministicMNList& mnList)
+{
+    size_t n = insecure_rand() % mnList.GetAllMNsCount();
+    CDeterministicMNCPtr ret;
+    mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+        if (n-- == 0) {
+            ret = dmn;
+        }
+    });
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_merkletree)
+{
+    seed_insecure_rand();
+
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (size_t i = 0; i < 100; i++) {
+        AddTestMN(mnList);
+    }
+
+    CSimplifiedMNListMerkleTree tree;
+    tree.Build(mnList);
+    BOOST_CHECK(tree.GetMerkleRoot() == CSimplifiedMNList(mnList).CalcMerkleRoot());
+
+    std::vector<CDeterministicMNList> lists{mnList};
+    for (size_t i = 0; i < 50; i++) {
+        CDeterministicMNList newList = mnList;
+        for (size_t j = insecure_rand() % 4; j > 0; j--) {
+            AddTestMN(newList);
+        }
+        for (size_t j = insecure_rand() % 4; j > 0; j--) {
+            auto dmn = GetRandomTestMN(newList);
+            auto state = std::make_shared<CDeterministicMNState>(*dmn->pdmnState);
+            if (insecure_rand() % 2) {
+                state->confirmedHash = GetRandHash();
+            } else {
+                // not part of the simplified entry
+                state->nLastPaidHeight++;
+            }
+            newList.UpdateMN(dmn->proTxHash, state);
+        }
+        for (size_t j = insecure_rand() % 3; j > 0 && newList.GetAllMNsCount() > 1; j--) {
+            newList.RemoveMN(GetRandomTestMN(newList)->proTxHash);
+        }
+
+        tree.Update(mnList, newList);
+        BOOST_CHECK_EQUAL(tree.GetSize(), newList.GetAllMNsCount());
+        BOOST_CHECK(tree.GetMerkleRoot() == CSimplifiedMNList(newList).CalcMerkleRoot());
+
+        mnList = newList;
+        lists.emplace_back(mnList);
+    }
+
+    // disconnecting blocks reverts the tree
+    for (auto it = lists.rbegin() + 1; it != lists.rend(); ++it) {
+        tree.Update(mnList, *it);
+        mnList = *it;
+        BOOST_CHECK(tree.GetMerkleRoot() == CSimplifiedMNList(mnList).CalcMerkleRoot());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,4 +1,6 @@
+#include "../batchproof_container.h"
 #include "../lelantus.h"
+#include "../txdb.h"
 #include "../validation.h"
 
 #include "fixtures.h"
@@ -252,6 +254,42 @@ BOOST_AUTO_TEST_CASE(mempool)
     BOOST_CHECK(!lelantusState->CanAddSpendToMempool(anotherSerial));
 }
 
+BOOST_AUTO_TEST_CASE(mempool_transactions)
+{
+    CLelantusMempoolState mempoolState;
+
+    auto tx1 = ArithToUint256(1), tx2 = ArithToUint256(2);
+    Scalar serial1(1), serial2(2), serial3(3);
+    GroupElement mint1, mint2;
+    mint1.randomize();
+    mint2.randomize();
+
+    mempoolState.AddTransaction(tx1, {serial1, serial2}, {mint1});
+    // serial2 is already spent by tx1 and stays with it
+    mempoolState.AddTransaction(tx2, {serial2, serial3}, {mint2});
+
+    BOOST_CHECK(mempoolState.HasCoinSerial(serial1));
+    BOOST_CHECK(mempoolState.HasMint(mint2));
+    BOOST_CHECK(tx1 == mempoolState.GetMempoolConflictingTxHash(serial2));
+    BOOST_CHECK(tx2 == mempoolState.GetMempoolConflictingTxHash(serial3));
+
+    BOOST_CHECK(std::set<uint256>({tx1, tx2}) == mempoolState.GetConflictingTxs({serial2}, {mint2}));
+    BOOST_CHECK(std::set<uint256>({tx1}) == mempoolState.GetConflictingTxs({serial1}, {}));
+    BOOST_CHECK(mempoolState.GetConflictingTxs({Scalar(4)}, {}).empty());
+
+    // removing a transaction drops only what it has added
+    BOOST_CHECK(mempoolState.RemoveTransaction(tx2));
+    BOOST_CHECK(!mempoolState.RemoveTransaction(tx2));
+    BOOST_CHECK(!mempoolState.HasCoinSerial(serial3));
+    BOOST_CHECK(!mempoolState.HasMint(mint2));
+    BOOST_CHECK(tx1 == mempoolState.GetMempoolConflictingTxHash(serial2));
+
+    BOOST_CHECK(mempoolState.RemoveTransaction(tx1));
+    BOOST_CHECK(!mempoolState.HasCoinSerial(serial1));
+    BOOST_CHECK(!mempoolState.HasCoinSerial(serial2));
+    BOOST_CHECK(!mempoolState.HasMint(mint1));
+}
+
 BOOST_AUTO_TEST_CASE(add_remove_block)
 {
     // No coins and serials
@@ -330,6 +368,187 @@ BOOST_AUTO_TEST_CASE(add_remove_block)
     lelantusState->Reset();
 }
 
+BOOST_AUTO_TEST_CASE(anonymity_set_cache)
+{
+    GenerateBlocks(120);
+
+    auto indexes = GenerateMintsInBlocks(*lelantusState, {2, 3});
+    GenerateBlocks(ZC_MINT_CONFIRMATIONS);
+
+    // cached set has to match the set built from the index
+    auto verifySet = [&](size_t expectedSize) {
+        std::vector<PublicCoin> coins;
+        lelantusState->GetAnonymitySet(1, true, coins);
+
+        std::vector<GroupElement> cachedCoins;
+        lelantusState->GetAnonymitySet(1, true, cachedCoins);
+
+        BOOST_CHECK_EQUAL(expectedSize, coins.size());
+        BOOST_CHECK_EQUAL(coins.size(), cachedCoins.size());
+        for (size_t i = 0; i != std::min(coins.size(), cachedCoins.size()); i++)
+            BOOST_CHECK(coins[i].getValue() == cachedCoins[i]);
+    };
+
+    auto &cache = lelantusState->GetAnonymitySetCache();
+    verifySet(5);
+    auto cachedBlocks = cache.GetCachedBlocksCount();
+    BOOST_CHECK_EQUAL(indexes.size(), cachedBlocks);
+
+    // group is in use, mints of connected blocks are cached right away
+    auto newIndexes = GenerateMintsInBlocks(*lelantusState, {4});
+    BOOST_CHECK_EQUAL(cachedBlocks + 1, cache.GetCachedBlocksCount());
+
+    GenerateBlocks(ZC_MINT_CONFIRMATIONS);
+    verifySet(9);
+
+    // disconnected blocks are dropped
+    RemoveBlocks(*lelantusState, newIndexes);
+    BOOST_CHECK_EQUAL(cachedBlocks, cache.GetCachedBlocksCount());
+    verifySet(5);
+
+    lelantusState->Reset();
+    BOOST_CHECK_EQUAL(0, cache.GetCachedBlocksCount());
+}
+
+BOOST_AUTO_TEST_CASE(anonymity_set_cache_limit)
+{
+    GenerateBlocks(120);
+
+    auto indexes = GenerateMintsInBlocks(*lelantusState, {2, 3, 4});
+    auto emptyIndex = GenerateBlock({});
+
+    LOCK(cs_main);
+
+    // blocks without coins of the group are not stored
+    CAnonymitySetCache unbounded;
+    BOOST_CHECK(unbounded.GetLelantusCoins(emptyIndex, 1, false)->empty());
+    BOOST_CHECK_EQUAL(0, unbounded.GetCachedBlocksCount());
+    BOOST_CHECK_EQUAL(0, unbounded.GetMemoryUsage());
+
+    std::vector<size_t> usages;
+    for (auto index : indexes) {
+        auto before = unbounded.GetMemoryUsage();
+        unbounded.GetLelantusCoins(index, 1, false);
+        usages.push_back(unbounded.GetMemoryUsage() - before);
+    }
+    BOOST_CHECK_EQUAL(indexes.size(), unbounded.GetCachedBlocksCount());
+
+    // room for the two last blocks only, the least recently used one is evicted
+    size_t limit = usages[1] + usages[2];
+    CAnonymitySetCache cache(limit);
+    for (size_t i = 0; i != indexes.size(); i++) {
+        auto coins = cache.GetLelantusCoins(indexes[i], 1, false);
+        BOOST_CHECK_EQUAL(i + 2, coins->size());
+        BOOST_CHECK(cache.GetMemoryUsage() <= limit);
+    }
+    BOOST_CHECK_EQUAL(2, cache.GetCachedBlocksCount());
+    BOOST_CHECK_EQUAL(limit, cache.GetMemoryUsage());
+
+    cache.GetLelantusCoins(indexes[1], 1, false);
+    cache.GetLelantusCoins(indexes[0], 1, false);
+    BOOST_CHECK_EQUAL(2, cache.GetCachedBlocksCount());
+    BOOST_CHECK_EQUAL(usages[0] + usages[1], cache.GetMemoryUsage());
+
+    cache.RemoveBlock(indexes[0]);
+    BOOST_CHECK_EQUAL(1, cache.GetCachedBlocksCount());
+    BOOST_CHECK_EQUAL(usages[1], cache.GetMemoryUsage());
+
+    cache.Reset();
+    BOOST_CHECK_EQUAL(0, cache.GetCachedBlocksCount());
+    BOOST_CHECK_EQUAL(0, cache.GetMemoryUsage());
+
+    lelantusState->Reset();
+}
+
+BOOST_AUTO_TEST_CASE(failed_batch_range_rollback)
+{
+    GenerateBlocks(120);
+
+    CValidationState state;
+    CBlockIndex *tip = chainActive.Tip();
+    int tipHeight = tip->nHeight;
+
+    {
+        LOCK(cs_main);
+
+        // nothing is disconnected if some block of the range can't be
+        CBlockIndex *noUndo = chainActive[tipHeight - 2];
+        noUndo->nStatus &= ~BLOCK_HAVE_UNDO;
+        BOOST_CHECK(!RollbackChainToHeight(state, ::Params(), tipHeight - 5));
+        BOOST_CHECK_EQUAL(tipHeight, chainActive.Height());
+        noUndo->nStatus |= BLOCK_HAVE_UNDO;
+
+        BOOST_CHECK(!RollbackChainToHeight(state, ::Params(), -1));
+        BOOST_CHECK_EQUAL(tipHeight, chainActive.Height());
+
+        BOOST_CHECK(RollbackChainToHeight(state, ::Params(), tipHeight - 5));
+        BOOST_CHECK_EQUAL(tipHeight - 5, chainActive.Height());
+    }
+
+    // the failed range is connected again
+    BOOST_CHECK(ActivateBestChain(state, ::Params()));
+    BOOST_CHECK(tip == chainActive.Tip());
+
+    // blocks left unverified when the chainstate was written are rolled back on startup
+    BOOST_CHECK(pblocktree->WriteFirstUnverifiedBatchHeight(tipHeight - 3));
+    BOOST_CHECK(RewindUnverifiedBatchBlocks(::Params()));
+    BOOST_CHECK_EQUAL(tipHeight - 4, chainActive.Height());
+
+    // nothing is left unverified, the height is erased by the flush
+    int unverifiedHeight;
+    BOOST_CHECK(!pblocktree->ReadFirstUnverifiedBatchHeight(unverifiedHeight));
+    BOOST_CHECK_EQUAL(-1, unverifiedHeight);
+
+    BOOST_CHECK(ActivateBestChain(state, ::Params()));
+    BOOST_CHECK(tip == chainActive.Tip());
+}
+
+BOOST_AUTO_TEST_CASE(disconnect_batched_mint_proofs)
+{
+    GenerateBlocks(110);
+
+    CValidationState state;
+    CBlockIndex *tip = chainActive.Tip();
+    int tipHeight = tip->nHeight;
+
+    // invalid mint proof of the tip, checked in background as the window holds a single proof
+    GroupElement comm;
+    comm.randomize();
+    Scalar challenge;
+    challenge.randomize();
+    lelantus::SchnorrProof proof;
+    proof.u.randomize();
+    proof.P1.randomize();
+    proof.T1.randomize();
+
+    ForceSetArg("-batchingwindow", "1");
+    BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
+    batchProofContainer->init();
+    batchProofContainer->fCollectProofs = true;
+    batchProofContainer->add(comm, challenge, proof);
+    batchProofContainer->finalize(tipHeight);
+    BOOST_CHECK(batchProofContainer->waitForParallelChecks());
+    BOOST_CHECK_EQUAL(tipHeight, batchProofContainer->getFirstUnverifiedHeight());
+
+    batchProofContainer->fCollectProofs = true;
+    BOOST_CHECK(batchProofContainer->verify());
+
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(RollbackChainToHeight(state, ::Params(), tipHeight - 1));
+        BOOST_CHECK_EQUAL(tipHeight - 1, chainActive.Height());
+    }
+
+    // proofs of the disconnected block are dropped instead of failing the range they were verified with
+    BOOST_CHECK(batchProofContainer->getFailedRange() == std::make_pair(-1, -1));
+    BOOST_CHECK_EQUAL(-1, batchProofContainer->getFirstUnverifiedHeight());
+    BOOST_CHECK(batchProofContainer->verify());
+
+    ForceSetArg("-batchingwindow", std::to_string(DEFAULT_BATCHING_WINDOW));
+    BOOST_CHECK(ActivateBestChain(state, ::Params()));
+    BOOST_CHECK(tip == chainActive.Tip());
+}
+
 BOOST_AUTO_TEST_CASE(get_coin_group)
 {
     GenerateBlocks(120);
@@ -414,6 +633,12 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     verifyMints(0, 6, coinOut1);
     BOOST_CHECK(indexes[2]->GetBlockHash() == blockHashOut1);
 
+    // snapshot is shared as long as the latest block of the set stays the same
+    auto coinSet1 = lelantusState->GetCoinSetSnapshotForSpend(&chainActive, indexes[2]->nHeight, 1);
+    BOOST_CHECK(coinSet1 == lelantusState->GetCoinSetSnapshotForSpend(&chainActive, indexes[2]->nHeight + 1, 1));
+    BOOST_CHECK_EQUAL(6, coinSet1->nCoins);
+    verifyMints(0, 6, coinSet1->coins);
+
     // 8 coins, 1(6), 2(4)
     addMintsToState(indexes[3], blocks[3]);
     verifyGroup(2, 4, indexes[2], indexes[3]);
@@ -497,6 +722,8 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
 
     verifyMints(0, 2, coinOut6);
     BOOST_CHECK(indexes[0]->GetBlockHash() == blockHashOut6);
+    BOOST_CHECK(coinSet1 != lelantusState->GetCoinSetSnapshotForSpend(&chainActive, indexes[0]->nHeight, 1));
+    verifyMints(0, 6, coinSet1->coins);
 
     lelantusState->RemoveBlock(indexes[5]);
     verifyGroup(2, 6, indexes[2], indexes[4]);
@@ -592,6 +819,47 @@ BOOST_AUTO_TEST_CASE(surge_condition_detected_and_no_serials_in_early_groups)
 #undef Detected
 #undef Undetected
 
+BOOST_AUTO_TEST_CASE(dump_and_load)
+{
+    GenerateBlocks(110);
+
+    CLelantusState state;
+    GenerateMintsInBlocks(state, {2, 3});
+    GenerateSpendGroups(state, {{1, 2}});
+
+    auto path = GetDataDir() / "lelantusstate.dat";
+    {
+        CAutoFile file(fopen(path.string().c_str(), "wb"), SER_DISK, CLIENT_VERSION);
+        state.Dump(file);
+    }
+
+    CLelantusState loaded;
+    {
+        CAutoFile file(fopen(path.string().c_str(), "rb"), SER_DISK, CLIENT_VERSION);
+        loaded.Load(file);
+    }
+
+    BOOST_CHECK_EQUAL(state.GetLatestCoinID(), loaded.GetLatestCoinID());
+    BOOST_CHECK_EQUAL(state.IsSurgeConditionDetected(), loaded.IsSurgeConditionDetected());
+    BOOST_CHECK(state.GetSpends() == loaded.GetSpends());
+
+    BOOST_CHECK_EQUAL(state.GetMints().size(), loaded.GetMints().size());
+    for (const auto& mint : state.GetMints()) {
+        BOOST_CHECK_EQUAL(
+            std::make_pair(mint.second.nHeight, mint.second.coinGroupId),
+            loaded.GetMintedCoinHeightAndId(mint.first));
+    }
+
+    BOOST_CHECK_EQUAL(state.GetCoinGroups().size(), loaded.GetCoinGroups().size());
+    for (const auto& group : state.GetCoinGroups()) {
+        CLelantusState::LelantusCoinGroupInfo info;
+        BOOST_CHECK(loaded.GetCoinGroupInfo(group.first, info));
+        BOOST_CHECK_EQUAL(group.second.firstBlock, info.firstBlock);
+        BOOST_CHECK_EQUAL(group.second.lastBlock, info.lastBlock);
+        BOOST_CHECK_EQUAL(group.second.nCoins, info.nCoins);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "../wallet/coincontrol.h"
 #include "../wallet/wallet.h"
 #include "../net.h"
+#include "../net_processing.h"
 
 #include "test_bitcoin.h"
 #include "fixtures.h"
@@ -626,6 +627,41 @@ BOOST_AUTO_TEST_CASE(checktransaction)
         joinsplitTx, state, joinsplitTx.GetHash(), false, chainActive.Height(), false, true, NULL, &info));
 }
 
+BOOST_AUTO_TEST_CASE(competing_joinsplit)
+{
+    GenerateBlocks(400);
+
+    std::vector<CMutableTransaction> txs;
+    GenerateMints({10 * CENT, 11 * CENT}, txs);
+    GenerateBlock(txs);
+    GenerateBlocks(10);
+
+    CWalletTx wtx;
+    pwalletMain->JoinSplitLelantus({{script, 8 * CENT, false}}, {}, wtx);
+    ::mempool.clear();
+
+    auto joinsplit = ParseLelantusJoinSplit(*wtx.tx);
+    const std::vector<Scalar> &serials = joinsplit->getCoinSerialNumbers();
+
+    LOCK(cs_main);
+
+    // a joinsplit spending a serial of another mempool joinsplit is rejected before its proof is verified,
+    // it is kept for compact blocks
+    ::mempool.lelantusState.AddTransaction(ArithToUint256(1), {serials[0]}, {});
+    CValidationState state;
+    BOOST_CHECK(!AcceptToMemoryPool(::mempool, state, wtx.tx, false, nullptr));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "txn-mempool-conflict");
+    BOOST_CHECK(IsCompetingJoinSplit(*wtx.tx, state));
+
+    // a serial spent on chain can never be mined again
+    ::mempool.clear();
+    lelantusState->AddSpend(serials[0], joinsplit->getCoinGroupIds()[0]);
+    state = CValidationState();
+    BOOST_CHECK(!AcceptToMemoryPool(::mempool, state, wtx.tx, false, nullptr));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "txn-mempool-conflict");
+    BOOST_CHECK(!IsCompetingJoinSplit(*wtx.tx, state));
+}
+
 BOOST_AUTO_TEST_CASE(move_to_v3_payload)
 {
     int prevHeight;
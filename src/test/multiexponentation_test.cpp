@@ -30,3 +30,35 @@ BOOST_AUTO_TEST_CASE(multiexponentation_test)
     }
 }
 
+
+BOOST_AUTO_TEST_CASE(fixed_base_multiexponentation_test)
+{
+    int size = 65;
+    std::vector<secp_primitives::GroupElement> gens(size);
+    std::vector<secp_primitives::Scalar> scalars(size);
+    for (int i = 0; i < size; ++i) {
+        gens[i].randomize();
+        scalars[i].randomize();
+    }
+    // edge cases of digit recoding
+    scalars[1] = secp_primitives::Scalar(uint64_t(0));
+    scalars[2] = secp_primitives::Scalar(uint64_t(1));
+    scalars[3] = secp_primitives::Scalar(uint64_t(0)) - secp_primitives::Scalar(uint64_t(1));
+    scalars[4] = secp_primitives::Scalar(uint64_t(32));
+
+    for (int window : {2, 4, 5, 6}) {
+        secp_primitives::FixedBaseMultiExponent fixedBases(gens, window);
+        BOOST_CHECK_EQUAL(fixedBases.size(), size);
+
+        secp_primitives::MultiExponent multiexponent(gens, scalars);
+        BOOST_CHECK_EQUAL(fixedBases.get_multiple(scalars), multiexponent.get_multiple());
+
+        // prefix of powers starting from some base
+        std::vector<secp_primitives::Scalar> part(scalars.begin(), scalars.begin() + 10);
+        std::vector<secp_primitives::GroupElement> partGens(gens.begin() + 7, gens.begin() + 17);
+        secp_primitives::MultiExponent partMultiexponent(partGens, part);
+        BOOST_CHECK_EQUAL(fixedBases.get_multiple(part, 7), partMultiexponent.get_multiple());
+
+        BOOST_CHECK_THROW(fixedBases.get_multiple(part, size - 5), std::invalid_argument);
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "proofcache.h"
+
+#include "chain.h"
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(proofcache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(entry_binding)
+{
+    uint256 txHash = GetRandHash();
+    uint256 hash1 = GetRandHash(), hash2 = GetRandHash();
+    CBlockIndex first, last, other;
+    first.phashBlock = &hash1;
+    last.phashBlock = &hash2;
+    other.phashBlock = &txHash;
+
+    uint256 entry = CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &last, true).GetHash();
+    BOOST_CHECK(entry == CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &last, true).GetHash());
+
+    // anything the anonymity set depends on changes the entry
+    BOOST_CHECK(entry != CProofCacheEntry(GetRandHash()).AddFlag(true).AddAnonymitySet(1, &first, &last, true).GetHash());
+    BOOST_CHECK(entry != CProofCacheEntry(txHash).AddFlag(false).AddAnonymitySet(1, &first, &last, true).GetHash());
+    BOOST_CHECK(entry != CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(2, &first, &last, true).GetHash());
+    BOOST_CHECK(entry != CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &other, true).GetHash());
+    BOOST_CHECK(entry != CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &last, false).GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(cache_lookup)
+{
+    uint256 txHash = GetRandHash();
+    uint256 hash1 = GetRandHash(), hash2 = GetRandHash();
+    CBlockIndex first, last;
+    first.phashBlock = &hash1;
+    last.phashBlock = &hash2;
+
+    uint256 entry = CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &last, true).GetHash();
+    BOOST_CHECK(!IsProofCached(entry, false));
+
+    AddProofToCache(entry);
+    BOOST_CHECK(IsProofCached(entry, false));
+
+    // the same transaction checked against other anonymity sets or flags is not found
+    BOOST_CHECK(!IsProofCached(CProofCacheEntry(txHash).AddFlag(false).AddAnonymitySet(1, &first, &last, true).GetHash(), false));
+    BOOST_CHECK(!IsProofCached(CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &first, true).GetHash(), false));
+    BOOST_CHECK(!IsProofCached(CProofCacheEntry(txHash).AddFlag(true).AddAnonymitySet(1, &first, &last, false).GetHash(), false));
+    BOOST_CHECK(!IsProofCached(CProofCacheEntry(GetRandHash()).GetHash(), false));
+
+    BOOST_CHECK(IsProofCached(entry, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
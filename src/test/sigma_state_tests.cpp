@@ -571,9 +571,9 @@ BOOST_AUTO_TEST_CASE(sigma_getcoingroupinfo_existing)
     sigmaState->GetCoinGroupInfo(pubcoin.getDenomination(), 1, result);
     BOOST_CHECK_MESSAGE(result.nCoins == 1,
         "Unexpected number of coins in group.");
-    BOOST_CHECK_MESSAGE(result.firstBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.firstBlock->sigmaMintedPubCoins.size() == index.sigmaMintedPubCoins.size(),
         "Unexpected first block index for Group info.");
-    BOOST_CHECK_MESSAGE(result.lastBlock->mintedPubCoins.size() == index.mintedPubCoins.size(),
+    BOOST_CHECK_MESSAGE(result.lastBlock->sigmaMintedPubCoins.size() == index.sigmaMintedPubCoins.size(),
         "Unexpected last block index for Group info.");
 
     sigmaState->Reset();
@@ -26,12 +26,14 @@ static const char DB_ADDRESSUNSPENTINDEX = 'u';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_SPENTINDEX = 'p';
 static const char DB_BLOCK_INDEX = 'b';
+static const char DB_PRIVACY_PAYLOAD = 'P';
 
 static const char DB_BEST_BLOCK = 'B';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 static const char DB_TOTAL_SUPPLY = 'S';
+static const char DB_UNVERIFIED_BATCH = 'v';
 
 namespace {
 
@@ -191,10 +193,17 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
+        // payload of a block never changes once connected, if it's not in memory it's already on disk
+        if ((*it)->fPrivacyPayloadLoaded && (*it)->HasPrivacyPayload())
+            batch.Write(std::make_pair(DB_PRIVACY_PAYLOAD, (*it)->GetBlockHash()), CDiskBlockPrivacyPayload(*it));
     }
     return WriteBatch(batch, true);
 }
 
+bool CBlockTreeDB::ReadPrivacyPayload(const uint256 &blockHash, CDiskBlockPrivacyPayload &payload) {
+    return Read(std::make_pair(DB_PRIVACY_PAYLOAD, blockHash), payload);
+}
+
 bool CBlockTreeDB::ReadTxIndex(const uint256 &txid, CDiskTxPos &pos) {
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
@@ -348,6 +357,17 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
+bool CBlockTreeDB::WriteFirstUnverifiedBatchHeight(int nHeight) {
+    if (nHeight < 0)
+        return Erase(DB_UNVERIFIED_BATCH, true);
+    return Write(DB_UNVERIFIED_BATCH, nHeight, true);
+}
+
+bool CBlockTreeDB::ReadFirstUnverifiedBatchHeight(int &nHeight) {
+    nHeight = -1;
+    return Read(DB_UNVERIFIED_BATCH, nHeight);
+}
+
 bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256&)> insertBlockIndex)
 {
     const auto &consensusParams = Params().GetConsensus();
@@ -355,6 +375,10 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Entries written by older versions carry the privacy payload, it's moved to its own index
+    CDBBatch upgradeBatch(*this);
+    size_t nUpgraded = 0;
+
     // Load mapBlockIndex
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
@@ -391,12 +415,25 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
                     pindexNew->reserved[1] = diskindex.reserved[1];
                 }
 
-                pindexNew->sigmaMintedPubCoins   = diskindex.sigmaMintedPubCoins;
-                pindexNew->sigmaSpentSerials     = diskindex.sigmaSpentSerials;
+                if (diskindex.HasPrivacyPayload()) {
+                    upgradeBatch.Write(std::make_pair(DB_PRIVACY_PAYLOAD, key.second), CDiskBlockPrivacyPayload(&diskindex));
+                    diskindex.ClearPrivacyPayload();
+                    upgradeBatch.Write(key, diskindex);
+                    nUpgraded++;
+
+                    if (upgradeBatch.SizeEstimate() >= (1 << 24)) {
+                        if (!WriteBatch(upgradeBatch))
+                            return error("LoadBlockIndex() : failed to move privacy payloads");
+                        upgradeBatch.Clear();
+                    }
+                }
 
-                pindexNew->lelantusMintedPubCoins   = diskindex.lelantusMintedPubCoins;
-                pindexNew->lelantusSpentSerials     = diskindex.lelantusSpentSerials;
-                pindexNew->anonymitySetHash         = diskindex.anonymitySetHash;
+                // privacy payload is read on demand, blocks before sigma have none
+                if (diskindex.nHeight >= consensusParams.nSigmaStartBlock) {
+                    pindexNew->fPrivacyPayloadLoaded = false;
+                    pindexNew->nLelantusMintsGroupId = -1;
+                }
+                pindexNew->anonymitySetHash      = diskindex.anonymitySetHash;
 
                 pindexNew->activeDisablingSporks = diskindex.activeDisablingSporks;
 
@@ -412,6 +449,12 @@ bool CBlockTreeDB::LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256
         }
     }
 
+    if (nUpgraded > 0) {
+        if (!WriteBatch(upgradeBatch, true))
+            return error("LoadBlockIndex() : failed to move privacy payloads");
+        LogPrintf("LoadBlockIndex(): moved privacy payloads of %d blocks to their own index\n", nUpgraded);
+    }
+
     return true;
 }
 
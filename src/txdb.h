@@ -19,6 +19,7 @@
 #include <boost/function.hpp>
 
 class CBlockIndex;
+class CDiskBlockPrivacyPayload;
 class CCoinsViewDBCursor;
 class uint256;
 
@@ -140,7 +141,10 @@ public:
     bool ReadTimestampIndex(const unsigned int &high, const unsigned int &low, std::vector<uint256> &vect);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
+    bool WriteFirstUnverifiedBatchHeight(int nHeight);
+    bool ReadFirstUnverifiedBatchHeight(int &nHeight);
     bool LoadBlockIndexGuts(boost::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    bool ReadPrivacyPayload(const uint256 &blockHash, CDiskBlockPrivacyPayload &payload);
     int GetBlockIndexVersion();
     int GetBlockIndexVersion(uint256 const & blockHash);
     bool AddTotalSupply(CAmount const & supply);
@@ -823,7 +823,7 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
             if (tx.vin.size() > 1) {
                 return state.Invalid(false, REJECT_CONFLICT, "txn-invalid-lelantus-joinsplit");
             }
-            std::unique_ptr<lelantus::JoinSplit> joinsplit;
+            std::shared_ptr<const lelantus::JoinSplit> joinsplit;
 
             try {
                 joinsplit = lelantus::ParseLelantusJoinSplit(tx);
@@ -851,19 +851,25 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
                 sigma::CoinDenomination denomination;
 
                 if (chainActive.Height() < consensus.nLelantusV3PayloadStartBlock || (joinsplit->isSigmaToLelantus() && sigma::IntegerToDenomination(intDenom, denomination))) {
-                    if (lelantusState->IsUsedCoinSerial(serials[i]) || pool.lelantusState.HasCoinSerial(serials[i]) ||
-                        !sigmaState->CanAddSpendToMempool(serials[i])) {
+                    if (lelantusState->IsUsedCoinSerial(serials[i]) || !sigmaState->CanAddSpendToMempool(serials[i])) {
                         LogPrintf("AcceptToMemoryPool(): lelantus serial number %s has been used\n",
                                   serials[i].tostring());
                         return state.Invalid(false, REJECT_CONFLICT, "txn-mempool-conflict");
                     }
                 } else {
-                    if (lelantusState->IsUsedCoinSerial(serials[i]) || pool.lelantusState.HasCoinSerial(serials[i])) {
+                    if (lelantusState->IsUsedCoinSerial(serials[i])) {
                         LogPrintf("AcceptToMemoryPool(): lelantus serial number %s has been used\n",
                                   serials[i].tostring());
                         return state.Invalid(false, REJECT_CONFLICT, "txn-mempool-conflict");
                     }
                 }
+                // told apart from other conflicts by the debug message, the joinsplit may be the spend a miner
+                // picked instead of ours, see IsCompetingJoinSplit
+                if (pool.lelantusState.HasCoinSerial(serials[i])) {
+                    LogPrintf("AcceptToMemoryPool(): lelantus serial number %s is spent by another mempool transaction\n",
+                              serials[i].tostring());
+                    return state.Invalid(false, REJECT_CONFLICT, "txn-mempool-conflict", "lelantus-serial-in-mempool");
+                }
                 lelantusSpendSerials.push_back(serials[i]);
             }
         }
@@ -1427,10 +1433,6 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
     }
 
     if (tx.IsLelantusJoinSplit()) {
-        if(markFiroSpendTransactionSerial) {
-            for (const auto &spendSerial: lelantusSpendSerials)
-                pool.lelantusState.AddSpendToMempool(spendSerial, hash);
-        }
         LogPrintf("Updating mint tracker state from Mempool..\n");
 #ifdef ENABLE_WALLET
         if (!GetBoolArg("-disablewallet", false) && pwalletMain->zwallet) {
@@ -1443,8 +1445,7 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
 
     if(markFiroSpendTransactionSerial) {
         sigmaState->AddMintsToMempool(zcMintPubcoinsV3);
-        for (const auto &pubCoin: lelantusMintPubcoins)
-            pool.lelantusState.AddMintToMempool(pubCoin);
+        pool.lelantusState.AddTransaction(hash, lelantusSpendSerials, lelantusMintPubcoins);
     }
 
 
@@ -2737,8 +2738,11 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     bool isMainNet = chainparams.GetConsensus().IsMain();
     // batch verify Lelantus/Sigma if block is older than a day, that means we are syncing or reindexing
     BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-    batchProofContainer->fCollectProofs = ((GetSystemTimeInSeconds() - pindex->GetBlockTime()) > 86400) && GetBoolArg("-batching", true);
-    batchProofContainer->init();
+    // blocks from a range which failed batch verification are rechecked proof by proof
+    batchProofContainer->fCollectProofs = ((GetSystemTimeInSeconds() - pindex->GetBlockTime()) > 86400) && GetBoolArg("-batching", true)
+            && !batchProofContainer->isFailedRange(pindex->nHeight);
+    batchProofContainer->fCacheResults = fJustCheck;
+    BlockProofChecksScope proofChecks(batchProofContainer);
 
     block.sigmaTxInfo = std::make_shared<sigma::CSigmaTxInfo>();
     block.lelantusTxInfo = std::make_shared<lelantus::CLelantusTxInfo>();
@@ -2849,6 +2853,11 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     }
 
+    // mint Schnorr proofs are verified in a single batch, unless collected for a batch verification round
+    if (!batchProofContainer->verifyMints())
+        return state.DoS(100, error("ConnectBlock(): lelantus mint verification failed"),
+                         REJECT_INVALID, "bad-txns-lelantus-mint");
+
     block.sigmaTxInfo->Complete();
     block.lelantusTxInfo->Complete();
 
@@ -2857,6 +2866,10 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     if (!control.Wait())
         return state.DoS(100, false);
+    // sigma and lelantus proofs were verified on the thread pool along with the scripts
+    if (!batchProofContainer->waitForParallelChecks())
+        return state.DoS(100, error("ConnectBlock(): sigma/lelantus proof verification failed"),
+                         REJECT_INVALID, "bad-txns-zerocoin");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint("bench", "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs]\n", nInputs - 1, 0.001 * (nTime4 - nTime2), nInputs <= 1 ? 0 : 0.001 * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * 0.000001);
 
@@ -2935,6 +2948,10 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         }
     }
 
+    // sigma and lelantus rebuild only their part of a payload read back from disk
+    if (!fJustCheck)
+        LoadPrivacyPayload(pindex);
+
     if (!sigma::ConnectBlockSigma(state, chainparams, pindex, &block, fJustCheck) ||
         !lelantus::ConnectBlockLelantus(state, chainparams, pindex, &block, fJustCheck))
         return false;
@@ -2994,7 +3011,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     view.SetBestBlock(pindex->GetBlockHash());
 
     // do batch verification if remains a day or collect proofs
-    batchProofContainer->finalize();
+    batchProofContainer->finalize(pindex->nHeight);
 
     int64_t nTime5 = GetTimeMicros(); nTimeIndex += nTime5 - nTime4;
     LogPrint("bench", "    - Index writing: %.2fms [%.2fs]\n", 0.001 * (nTime5 - nTime4), nTimeIndex * 0.000001);
@@ -3020,8 +3037,12 @@ void static RemoveConflictingPrivacyTransactionsFromMempool(const CBlock &block)
 
     // Erase conflicting sigma/lelantus txs from the mempool
     sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
-    lelantus::CLelantusState *lelantusState = lelantus::CLelantusState::GetState();
+    std::vector<Scalar> lelantusSerials;
+    std::vector<GroupElement> lelantusMints;
+    std::set<uint256> blockTxHashes;
     BOOST_FOREACH(CTransactionRef tx, block.vtx) {
+        if (tx->IsLelantusTransaction())
+            blockTxHashes.insert(tx->GetHash());
         if (tx->IsSigmaSpend()) {
             BOOST_FOREACH(const CTxIn &txin, tx->vin)
             {
@@ -3042,31 +3063,13 @@ void static RemoveConflictingPrivacyTransactionsFromMempool(const CBlock &block)
             }
         }
         else if (tx->IsLelantusJoinSplit()) {
-           std::vector<Scalar> serials;
-           try {
-               serials = lelantus::GetLelantusJoinSplitSerialNumbers(*tx, tx->vin[0]);
-           } catch (CBadTxIn&) {
-               // nothing
-           }
-
-           uint256 thisTxHash = tx->GetHash();
-            uint256 conflictingTxHash;
-           for(const auto& serial : serials) {
-                conflictingTxHash = lelantusState->GetMempoolConflictingTxHash(serial);
-                if(!conflictingTxHash.IsNull())
-                    break;
-           }
-           if (!conflictingTxHash.IsNull() && conflictingTxHash != thisTxHash) {
-               std::list<CTransaction> removed;
-               auto pTx = mempool.get(conflictingTxHash);
-               if (pTx)
-                   mempool.removeRecursive(*pTx);
-                LogPrintf("ConnectBlock: removed conflicting lelantus joinsplit tx %s from the mempool\n",
-                           conflictingTxHash.ToString());
-           }
-
-           // In any case we need to remove serial from mempool set
-           lelantusState->RemoveSpendFromMempool(serials);
+            try {
+                auto joinsplit = lelantus::ParseLelantusJoinSplit(*tx);
+                const std::vector<Scalar>& serials = joinsplit->getCoinSerialNumbers();
+                lelantusSerials.insert(lelantusSerials.end(), serials.begin(), serials.end());
+            } catch (...) {
+                // nothing
+            }
         }
         BOOST_FOREACH(const CTxOut &txout, tx->vout)
         {
@@ -3083,13 +3086,25 @@ void static RemoveConflictingPrivacyTransactionsFromMempool(const CBlock &block)
                 GroupElement pubCoinValue;
                 try {
                     lelantus::ParseLelantusMintScript(txout.scriptPubKey, pubCoinValue);
+                    lelantusMints.push_back(pubCoinValue);
                 } catch (std::invalid_argument&) {
                     // nothing
                 }
-                lelantusState->RemoveMintFromMempool(pubCoinValue);
             }
         }
     }
+
+    // Mempool transactions spending or minting the same lelantus coins as the block are found with a single
+    // pass over the index, the block transactions themselves leave the mempool in removeForBlock
+    for (const uint256& conflictingTxHash : mempool.lelantusState.GetConflictingTxs(lelantusSerials, lelantusMints)) {
+        if (blockTxHashes.count(conflictingTxHash) > 0)
+            continue;
+        auto pTx = mempool.get(conflictingTxHash);
+        if (pTx)
+            mempool.removeRecursive(*pTx);
+        LogPrintf("ConnectBlock: removed conflicting lelantus tx %s from the mempool\n",
+                   conflictingTxHash.ToString());
+    }
 }
 
 /**
@@ -3105,6 +3120,7 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
     static int64_t nLastWrite = 0;
     static int64_t nLastFlush = 0;
     static int64_t nLastSetChain = 0;
+    static int64_t nLastPrivacyStateDump = 0;
     std::set<int> setFilesToPrune;
     bool fFlushForPrune = false;
     try {
@@ -3134,6 +3150,9 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
     if (nLastSetChain == 0) {
         nLastSetChain = nNow;
     }
+    if (nLastPrivacyStateDump == 0) {
+        nLastPrivacyStateDump = nNow;
+    }
     int64_t nMempoolSizeMax = GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     int64_t cacheSize = pcoinsTip->DynamicMemoryUsage() * DB_PEAK_USAGE_FACTOR;
     cacheSize += evoDb->GetMemoryUsage() * EVO_DB_USAGE_FACTOR * DB_PEAK_USAGE_FACTOR;
@@ -3187,6 +3206,9 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
         // overwrite one. Still, use a conservative safety factor of 2.
         if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
             return state.Error("out of disk space");
+        // Blocks of the chainstate with batched proofs not verified yet are connected again on startup
+        if (!pblocktree->WriteFirstUnverifiedBatchHeight(BatchProofContainer::get_instance()->getFirstUnverifiedHeight()))
+            return AbortNode(state, "Failed to write to block index database");
         // Flush the chainstate (which may refer to block index entries).
         if (!pcoinsTip->Flush())
             return AbortNode(state, "Failed to write to coin database");
@@ -3194,6 +3216,11 @@ bool static FlushStateToDisk(CValidationState &state, FlushStateMode mode, int n
             return AbortNode(state, "Failed to commit EvoDB");
         }
         nLastFlush = nNow;
+        // The states are dumped at the tip of the chainstate just written, on shutdown it's done by the caller
+        if (mode != FLUSH_STATE_ALWAYS && nNow > nLastPrivacyStateDump + (int64_t)PRIVACY_STATE_DUMP_INTERVAL * 1000000) {
+            DumpPrivacyState();
+            nLastPrivacyStateDump = nNow;
+        }
     }
     if (fDoFullFlush || ((mode == FLUSH_STATE_ALWAYS || mode == FLUSH_STATE_PERIODIC) && nNow > nLastSetChain + (int64_t)DATABASE_WRITE_INTERVAL * 1000000)) {
         // Update best block in wallet (so we can detect restored wallets).
@@ -3309,7 +3336,7 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
             false, false, block.sigmaTxInfo.get(), block.lelantusTxInfo.get());
         if(GetBoolArg("-batching", true)) {
             if (tx->IsLelantusJoinSplit()) {
-                std::unique_ptr<lelantus::JoinSplit> joinsplit;
+                std::shared_ptr<const lelantus::JoinSplit> joinsplit;
 
                 try {
                     joinsplit = lelantus::ParseLelantusJoinSplit(*tx);
@@ -3379,7 +3406,7 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
     if (rangeProofsToRemove.size() > 0) {
         batchProofContainer->remove(rangeProofsToRemove);
     }
-
+    batchProofContainer->removeBlock(pindexDelete->nHeight);
 
     // Roll back MTP state
     MTPState::GetMTPState()->SetLastBlock(pindexDelete->pprev, chainparams.GetConsensus());
@@ -3475,6 +3502,31 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
     return true;
 }
 
+bool RollbackChainToHeight(CValidationState& state, const CChainParams& chainparams, int nHeight, bool fBare)
+{
+    AssertLockHeld(cs_main);
+    if (nHeight < 0)
+        return error("%s: invalid rollback height %d", __func__, nHeight);
+
+    // check the whole range first, blocks which can't be disconnected would leave the chain half rolled back
+    for (CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->nHeight > nHeight; pindex = pindex->pprev) {
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !(pindex->nStatus & BLOCK_HAVE_UNDO))
+            return error("%s: block %s at height %d is pruned or has no undo data, can't roll back to height %d",
+                         __func__, pindex->GetBlockHash().ToString(), pindex->nHeight, nHeight);
+    }
+
+    bool fSuccess = true;
+    while (chainActive.Height() > nHeight) {
+        if (!DisconnectTip(state, chainparams, fBare)) {
+            fSuccess = false;
+            break;
+        }
+    }
+    if (!fBare)
+        txpools.removeForReorg(pcoinsTip, chainActive.Tip()->nHeight + 1, STANDARD_LOCKTIME_VERIFY_FLAGS);
+    return fSuccess;
+}
+
 static int64_t nTimeReadFromDisk = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
@@ -3965,7 +4017,20 @@ bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams,
         // Do batch verification if we reach 1 day old block,
         BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
         batchProofContainer->fCollectProofs = ((GetSystemTimeInSeconds() - pindexNewTip->GetBlockTime()) > 86400) && GetBoolArg("-batching", true);
-        batchProofContainer->verify();
+        if (!batchProofContainer->verify()) {
+            // Some proof in the failed range is invalid, disconnect the range and connect it again
+            // verifying proofs one by one, the bad block will be found and marked invalid there
+            LOCK(cs_main);
+            std::pair<int, int> failedRange = batchProofContainer->getFailedRange();
+            LogPrintf("%s: rolling back to height %d after failed batch verification\n", __func__, failedRange.first - 1);
+            if (!RollbackChainToHeight(state, chainparams, failedRange.first - 1))
+                return AbortNode(state, strprintf("Failed to roll back blocks %d-%d which failed batch verification",
+                                                  failedRange.first, failedRange.second),
+                                 _("Batch verification of blocks failed and they can't be verified again. Please restart with -reindex -batching=0."));
+            pindexMostWork = NULL;
+            pindexNewTip = chainActive.Tip();
+            continue;
+        }
 
         // When we reach this point, we switched to a new tip (stored in pindexNewTip).
 
@@ -5095,6 +5160,44 @@ CBlockIndex * InsertBlockIndex(uint256 hash)
     return pindexNew;
 }
 
+void LoadPrivacyPayload(CBlockIndex *pindex)
+{
+    AssertLockHeld(cs_main);
+    if (pindex->fPrivacyPayloadLoaded)
+        return;
+
+    // blocks without sigma or lelantus transactions have no entry
+    CDiskBlockPrivacyPayload payload;
+    if (pblocktree->ReadPrivacyPayload(pindex->GetBlockHash(), payload))
+        payload.MoveTo(pindex);
+    pindex->fPrivacyPayloadLoaded = true;
+}
+
+void ReleasePrivacyPayloads(const CChain& chain)
+{
+    size_t nReleased = 0;
+    for (CBlockIndex *pindex = chain.Genesis(); pindex; pindex = chain.Next(pindex)) {
+        // entries not flushed yet must keep the payload until it's written
+        if (!pindex->fPrivacyPayloadLoaded || !pindex->HasPrivacyPayload() || setDirtyBlockIndex.count(pindex))
+            continue;
+
+        pindex->nLelantusMintsGroupId = 0;
+        pindex->nLelantusMints = 0;
+        if (pindex->lelantusMintedPubCoins.size() > 1) {
+            // the summary holds a single group, the few blocks spanning two groups read the payload again when counted
+            pindex->nLelantusMintsGroupId = -1;
+        } else if (!pindex->lelantusMintedPubCoins.empty()) {
+            pindex->nLelantusMintsGroupId = pindex->lelantusMintedPubCoins.begin()->first;
+            pindex->nLelantusMints = pindex->lelantusMintedPubCoins.begin()->second.size();
+        }
+
+        pindex->ClearPrivacyPayload();
+        pindex->fPrivacyPayloadLoaded = false;
+        nReleased++;
+    }
+    LogPrintf("%s: released privacy payloads of %d blocks\n", __func__, nReleased);
+}
+
 bool static LoadBlockIndexDB(const CChainParams& chainparams)
 {
     LogPrintf("LoadBlockIndexDB\n");
@@ -5216,8 +5319,15 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
 
     PruneBlockIndexCandidates();
 
-    sigma::BuildSigmaStateFromIndex(&chainActive);
-    lelantus::BuildLelantusStateFromIndex(&chainActive);
+    int64_t nStart = GetTimeMillis();
+    const CBlockIndex *pindexStateDump = LoadPrivacyState();
+    sigma::BuildSigmaStateFromIndex(&chainActive, pindexStateDump);
+    lelantus::BuildLelantusStateFromIndex(&chainActive, pindexStateDump);
+    ReleasePrivacyPayloads(chainActive);
+    LogPrintf("%s: sigma and lelantus states loaded at height %d, %d blocks replayed: %dms\n", __func__,
+        pindexStateDump ? pindexStateDump->nHeight : -1,
+        chainActive.Height() - (pindexStateDump ? pindexStateDump->nHeight : -1),
+        GetTimeMillis() - nStart);
 
     // Initialize MTP state
     MTPState::GetMTPState()->InitializeFromChain(&chainActive, chainparams.GetConsensus());
@@ -5339,6 +5449,22 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     return true;
 }
 
+bool RewindUnverifiedBatchBlocks(const CChainParams& params)
+{
+    LOCK(cs_main);
+
+    int nHeight;
+    if (!pblocktree->ReadFirstUnverifiedBatchHeight(nHeight) || nHeight < 0 || nHeight > chainActive.Height())
+        return true;
+
+    LogPrintf("%s: batched proofs of blocks from height %d were not verified, rolling back to height %d\n",
+              __func__, nHeight, nHeight - 1);
+    CValidationState state;
+    if (!RollbackChainToHeight(state, params, nHeight - 1, true))
+        return false;
+    return FlushStateToDisk(state, FLUSH_STATE_ALWAYS);
+}
+
 bool RewindBlockIndex(const CChainParams& params)
 {
     LOCK(cs_main);
@@ -5834,6 +5960,7 @@ int VersionBitsTipStateSinceHeight(const Consensus::Params& params, Consensus::D
 }
 
 static const uint64_t MEMPOOL_DUMP_VERSION = 1;
+static const uint64_t PRIVACY_STATE_DUMP_VERSION = 1;
 
 bool LoadMempool(void)
 {
@@ -5948,6 +6075,74 @@ void DumpMempool(void)
     }
 }
 
+const CBlockIndex* LoadPrivacyState()
+{
+    FILE* filestr = fopen((GetDataDir() / "privacystate.dat").string().c_str(), "rb");
+    CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        return nullptr;
+    }
+
+    try {
+        uint64_t version;
+        file >> version;
+        if (version != PRIVACY_STATE_DUMP_VERSION) {
+            return nullptr;
+        }
+
+        uint256 hashBlock;
+        file >> hashBlock;
+        BlockMap::iterator it = mapBlockIndex.find(hashBlock);
+        if (it == mapBlockIndex.end() || !chainActive.Contains(it->second)) {
+            LogPrintf("Dumped sigma and lelantus states are not on the active chain, rebuilding them\n");
+            return nullptr;
+        }
+
+        sigma::CSigmaState::GetState()->Load(file);
+        lelantus::CLelantusState::GetState()->Load(file);
+        return it->second;
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to deserialize sigma and lelantus states: %s. Rebuilding them\n", e.what());
+        sigma::CSigmaState::GetState()->Reset();
+        lelantus::CLelantusState::GetState()->Reset();
+        return nullptr;
+    }
+}
+
+void DumpPrivacyState()
+{
+    AssertLockHeld(cs_main);
+
+    const CBlockIndex *tip = chainActive.Tip();
+    if (!tip)
+        return;
+
+    int64_t start = GetTimeMicros();
+
+    try {
+        FILE* filestr = fopen((GetDataDir() / "privacystate.dat.new").string().c_str(), "wb");
+        if (!filestr) {
+            return;
+        }
+
+        CAutoFile file(filestr, SER_DISK, CLIENT_VERSION);
+
+        uint64_t version = PRIVACY_STATE_DUMP_VERSION;
+        file << version;
+        file << tip->GetBlockHash();
+
+        sigma::CSigmaState::GetState()->Dump(file);
+        lelantus::CLelantusState::GetState()->Dump(file);
+
+        FileCommit(file.Get());
+        file.fclose();
+        RenameOver(GetDataDir() / "privacystate.dat.new", GetDataDir() / "privacystate.dat");
+        LogPrintf("Dumped sigma and lelantus states at height %d: %gs\n", tip->nHeight, (GetTimeMicros() - start) * 0.000001);
+    } catch (const std::exception& e) {
+        LogPrintf("Failed to dump sigma and lelantus states: %s. Continuing anyway.\n", e.what());
+    }
+}
+
 //! Guess how far we are in the verification process at the given block index
 double GuessVerificationProgress(const ChainTxData& data, CBlockIndex *pindex) {
     if (pindex == NULL)
@@ -111,6 +111,8 @@ static const unsigned int BLOCK_DOWNLOAD_WINDOW = 1024;
 static const unsigned int DATABASE_WRITE_INTERVAL = 60 * 60;
 /** Time to wait (in seconds) between flushing chainstate to disk. */
 static const unsigned int DATABASE_FLUSH_INTERVAL = 24 * 60 * 60;
+/** Time to wait (in seconds) between dumping sigma and lelantus states to disk. */
+static const unsigned int PRIVACY_STATE_DUMP_INTERVAL = 6 * 60 * 60;
 /** Maximum length of reject messages. */
 static const unsigned int MAX_REJECT_MESSAGE_LENGTH = 111;
 /** Average delay between local address broadcasts in seconds. */
@@ -347,6 +349,10 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 
 /** Create a new block index entry for a given block hash */
 CBlockIndex * InsertBlockIndex(uint256 hash);
+/** Read sigma and lelantus mints and spends of the block from the block tree db if they are not in memory */
+void LoadPrivacyPayload(CBlockIndex *pindex);
+/** Drop the mints and spends of the chain blocks from memory, keeping the summary of lelantus mints */
+void ReleasePrivacyPayloads(const CChain& chain);
 /** Abort with a message */
 bool AbortNode(const std::string &strMessage, const std::string &userMessage);
 /** Sends out an alert */
@@ -577,6 +583,15 @@ bool IsWitnessEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& pa
 /** When there are blocks in the active chain with missing data, rewind the chainstate and remove them from the block index */
 bool RewindBlockIndex(const CChainParams& params);
 
+/**
+ * Disconnect blocks of the active chain above nHeight, with cs_main held. Fails without disconnecting anything
+ * if some of them is pruned or has no undo data.
+ */
+bool RollbackChainToHeight(CValidationState& state, const CChainParams& chainparams, int nHeight, bool fBare = false);
+
+/** Disconnect blocks whose batched proofs were not verified when the chainstate was written, they are verified when connected again */
+bool RewindUnverifiedBatchBlocks(const CChainParams& params);
+
 /** Update uncommitted block structures (currently: only the witness nonce). This is safe for submitted blocks. */
 void UpdateUncommittedBlockStructures(CBlock& block, const CBlockIndex* pindexPrev, const Consensus::Params& consensusParams);
 
@@ -644,6 +659,12 @@ CBlockFileInfo* GetBlockFileInfo(size_t n);
 /** Dump the mempool to disk. */
 void DumpMempool();
 
+/** Dump the sigma and lelantus states at the current tip to disk */
+void DumpPrivacyState();
+
+/** Load the dumped sigma and lelantus states, returns the block of the active chain they were dumped at */
+const CBlockIndex* LoadPrivacyState();
+
 /** Load the mempool from disk. */
 bool LoadMempool();
 
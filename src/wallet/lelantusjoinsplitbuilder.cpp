@@ -467,23 +467,18 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
         }
 
         coins.emplace_back(std::make_pair(priv, groupId));
-        std::vector<unsigned char> setHash;
         if (anonymity_sets.count(groupId) == 0) {
-            std::vector<lelantus::PublicCoin> set;
-            uint256 blockHash;
-            if (state->GetCoinSetForSpend(
+            auto coinSet = state->GetCoinSetSnapshotForSpend(
                     &chainActive,
                     chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
-                    groupId,
-                    blockHash,
-                    set,
-                    setHash) < 2)
+                    groupId);
+            if (coinSet->nCoins < 2)
                 throw std::runtime_error(
                         _("Has to have at least two mint coins with at least 1 confirmation in order to spend a coin"));
-            groupBlockHashes[groupId] = blockHash;
-            anonymity_sets[groupId] = set;
-            if (!setHash.empty())
-                anonymity_set_hashes.push_back(setHash);
+            groupBlockHashes[groupId] = coinSet->blockHash;
+            anonymity_sets[groupId] = coinSet->coins;
+            if (!coinSet->setHash.empty())
+                anonymity_set_hashes.push_back(coinSet->setHash);
         }
     }
 
@@ -500,7 +495,9 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
         priv.setSerialNumber(spend.serialNumber);
         priv.setRandomness(spend.randomness);
         priv.setEcdsaSeckey(spend.ecdsaSecretKey);
-        lelantus::PublicCoin lPub(spend.value + params->get_h1() * denom);
+        // denomination part is the same for every coin of the set
+        GroupElement h1Denom = params->get_h1() * denom;
+        lelantus::PublicCoin lPub(spend.value + h1Denom);
         priv.setPublicCoin(lPub);
 
         // get coin group
@@ -532,7 +529,7 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
             std::vector<lelantus::PublicCoin> set;
             set.reserve(group.size());
             for(auto& coin : group) {
-                set.push_back(coin.getValue() + params->get_h1() * denom);
+                set.push_back(coin.getValue() + h1Denom);
             }
             groupBlockHashes[denom / 1000 + groupId] = blockHash;
             anonymity_sets[denom / 1000 + groupId] = set;
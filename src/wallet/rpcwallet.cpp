@@ -2658,6 +2658,54 @@ UniValue getwalletinfo(const JSONRPCRequest& request)
     return obj;
 }
 
+UniValue getrescaninfo(const JSONRPCRequest& request)
+{
+    CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp)) {
+        return NullUniValue;
+    }
+
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getrescaninfo\n"
+            "Returns the progress of the running or last wallet rescan.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"scanning\": true|false,       (boolean) whether the wallet is being rescanned\n"
+            "  \"startHeight\": xxxxx,         (numeric) the height the rescan started at\n"
+            "  \"height\": xxxxx,              (numeric) the height of the last scanned block\n"
+            "  \"tipHeight\": xxxxx,           (numeric) the chain tip height when the rescan started\n"
+            "  \"progress\": x.xxx,            (numeric) the fraction of blocks scanned\n"
+            "  \"blocks\": xxxxx,              (numeric) the number of scanned blocks\n"
+            "  \"transactions\": xxxxx,        (numeric) the number of scanned transactions\n"
+            "  \"elapsed\": xxxxx,             (numeric) the time spent scanning, in seconds\n"
+            "  \"blocksPerSecond\": x.xxx      (numeric) the scan throughput\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getrescaninfo", "")
+            + HelpExampleRpc("getrescaninfo", "")
+        );
+
+    // doesn't take cs_wallet, which is held by the rescan
+    CWalletRescanProgress progress = pwallet->GetRescanProgress();
+
+    int nTotal = progress.nTipHeight - progress.nStartHeight + 1;
+    int64_t nEndTime = progress.fScanning ? GetTimeMillis() : progress.nEndTime;
+    double dElapsed = progress.nStartTime ? (nEndTime - progress.nStartTime) / 1000.0 : 0.0;
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("scanning", progress.fScanning));
+    obj.push_back(Pair("startHeight", progress.nStartHeight));
+    obj.push_back(Pair("height", progress.nHeight));
+    obj.push_back(Pair("tipHeight", progress.nTipHeight));
+    obj.push_back(Pair("progress", nTotal > 0 ? std::min(1.0, (double)progress.nBlocks / nTotal) : 1.0));
+    obj.push_back(Pair("blocks", progress.nBlocks));
+    obj.push_back(Pair("transactions", progress.nTransactions));
+    obj.push_back(Pair("elapsed", dElapsed));
+    obj.push_back(Pair("blocksPerSecond", dElapsed > 0.0 ? progress.nBlocks / dElapsed : 0.0));
+    return obj;
+}
+
 UniValue resendwallettransactions(const JSONRPCRequest& request)
 {
     CWallet * const pwallet = GetWalletForJSONRPCRequest(request);
@@ -4103,7 +4151,7 @@ UniValue listlelantusjoinsplits(const JSONRPCRequest& request) {
         entry.push_back(Pair("abandoned", pwtx->isAbandoned()));
 
         UniValue spends(UniValue::VARR);
-        std::unique_ptr<lelantus::JoinSplit> joinsplit;
+        std::shared_ptr<const lelantus::JoinSplit> joinsplit;
         try {
             joinsplit = lelantus::ParseLelantusJoinSplit(*pwtx->tx);
         } catch (...) {
@@ -4847,6 +4895,7 @@ static const CRPCCommand commands[] =
     { "wallet",             "gettransaction",           &gettransaction,           false,  {"txid","include_watchonly"} },
     { "wallet",             "getunconfirmedbalance",    &getunconfirmedbalance,    false,  {} },
     { "wallet",             "getwalletinfo",            &getwalletinfo,            false,  {} },
+    { "wallet",             "getrescaninfo",            &getrescaninfo,            true,   {} },
     { "wallet",             "importmulti",              &importmulti,              true,   {"requests","options"} },
     { "wallet",             "importprivkey",            &importprivkey,            true,   {"privkey","label","rescan"} },
     { "wallet",             "importwallet",             &importwallet,             true,   {"filename"} },
@@ -22,6 +22,7 @@
 #include "../sigma/spend_metadata.h"
 #include "../sigma/coin.h"
 #include "lelantus.h"
+#include "batchproof_container.h"
 #include "llmq/quorums_instantsend.h"
 #include "llmq/quorums_chainlocks.h"
 #include "net.h"
@@ -50,6 +51,7 @@
 #include "evo/deterministicmns.h"
 
 #include <assert.h>
+#include <limits>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
@@ -59,6 +61,7 @@
 #include "bip47/account.h"
 #include "bip47/paymentcode.h"
 #include "bip47/bip47utils.h"
+#include "liblelantus/threadpool.h"
 
 CWallet* pwalletMain = NULL;
 
@@ -1425,7 +1428,7 @@ bool CWallet::AbandonTransaction(const uint256& hashTx)
             // find out coin serial number
             assert(wtx.tx->vin.size() == 1);
 
-            std::unique_ptr<lelantus::JoinSplit> joinsplit;
+            std::shared_ptr<const lelantus::JoinSplit> joinsplit;
             try {
                 joinsplit = lelantus::ParseLelantusJoinSplit(*wtx.tx);
             }
@@ -1590,7 +1593,7 @@ isminetype CWallet::IsMine(const CTxIn &txin, const CTransaction& tx) const
         }
     } else if (txin.IsLelantusJoinSplit()) {
         CWalletDB db(strWalletFile);
-        std::unique_ptr<lelantus::JoinSplit> joinsplit;
+        std::shared_ptr<const lelantus::JoinSplit> joinsplit;
         try {
             joinsplit = lelantus::ParseLelantusJoinSplit(tx);
         }
@@ -1651,7 +1654,7 @@ CAmount CWallet::GetDebit(const CTxIn &txin, const CTransaction& tx, const ismin
         }
 
         CWalletDB db(strWalletFile);
-        std::unique_ptr<lelantus::JoinSplit> joinsplit;
+        std::shared_ptr<const lelantus::JoinSplit> joinsplit;
         try {
             joinsplit = lelantus::ParseLelantusJoinSplit(tx);
         }
@@ -2143,11 +2146,57 @@ void CWalletTx::GetAmounts(std::list<COutputEntry>& listReceived,
 
 }
 
+namespace {
+
+// Block of a wallet rescan, read from disk and matched against the wallet keys on the shared thread pool
+struct RescanBlock
+{
+    CBlockIndex* pindex;
+    CDiskBlockPos pos;
+    uint256 hash;
+
+    bool fRead{false};
+    CBlock block;
+    // transactions which may involve the wallet, see CWallet::MayInvolveMe
+    std::vector<bool> vMaybeMine;
+    // wallet key generation when matching started, matches are outdated if keys were generated since then
+    uint64_t nKeyGeneration{0};
+};
+
+// Blocks prefetched while the previous ones are applied to the wallet
+struct RescanBatch
+{
+    std::vector<RescanBlock> blocks;
+    // declared last to wait for the tasks before the blocks are destroyed
+    std::unique_ptr<WorkStealingThreadPool::TaskGroup> tasks;
+};
+
+} // namespace
+
+bool CWallet::MayInvolveMe(const CTransaction& tx) const
+{
+    for (const CTxIn& txin : tx.vin) {
+        if (txin.IsSigmaSpend() || txin.IsLelantusJoinSplit())
+            return true;
+    }
+    for (const CTxOut& txout : tx.vout) {
+        const CScript& script = txout.scriptPubKey;
+        if (script.IsSigmaMint() || script.IsLelantusMint() || script.IsLelantusJMint())
+            return true;
+        if (::IsMine(*this, script) != ISMINE_NO)
+            return true;
+    }
+    return false;
+}
+
 /**
  * Scan the block chain (starting in pindexStart) for transactions
  * from or to us. If fUpdate is true, found transactions that already
  * exist in the wallet will be updated.
  *
+ * Blocks are read, checked and matched against the wallet keys ahead of time on the shared thread pool, wallet
+ * updates are applied in chain order.
+ *
  * Returns pointer to the first block in the last contiguous range that was
  * successfully scanned.
  *
@@ -2176,36 +2225,135 @@ CBlockIndex* CWallet::ScanForWalletTransactions(CBlockIndex *pindexStart, bool f
         ShowProgress(_("Rescanning..."), 0); // show rescan progress in GUI as dialog or on splashscreen, if -rescan on startup
         double dProgressStart = GuessVerificationProgress(chainParams.TxData(), pindex);
         double dProgressTip = GuessVerificationProgress(chainParams.TxData(), chainActive.Tip());
-        while (pindex)
+
+        {
+            LOCK(cs_rescanProgress);
+            rescanProgress = CWalletRescanProgress();
+            rescanProgress.fScanning = true;
+            rescanProgress.nStartHeight = rescanProgress.nHeight = pindex ? pindex->nHeight : chainActive.Height();
+            rescanProgress.nTipHeight = chainActive.Height();
+            rescanProgress.nStartTime = GetTimeMillis();
+        }
+
+        // bumped whenever scanned transactions made the wallet generate keys
+        std::atomic<uint64_t> nKeyGeneration{0};
+        const Consensus::Params& consensusParams = chainParams.GetConsensus();
+        size_t nBatchSize = std::max<size_t>(16, 4 * WorkStealingThreadPool::GetInstance().GetNumberOfThreads());
+
+        auto prefetch = [&](CBlockIndex* pindexFrom) {
+            std::unique_ptr<RescanBatch> batch(new RescanBatch());
+            for (CBlockIndex* p = pindexFrom; p && batch->blocks.size() < nBatchSize; p = chainActive.Next(p)) {
+                batch->blocks.emplace_back();
+                batch->blocks.back().pindex = p;
+                batch->blocks.back().pos = p->GetBlockPos();
+                batch->blocks.back().hash = p->GetBlockHash();
+            }
+            batch->tasks.reset(new WorkStealingThreadPool::TaskGroup());
+            for (RescanBlock& b : batch->blocks) {
+                batch->tasks->Run([this, &b, &nKeyGeneration, &consensusParams]() {
+                    b.nKeyGeneration = nKeyGeneration;
+                    if (!ReadBlockFromDisk(b.block, b.pos, b.pindex->nHeight, consensusParams))
+                        return true;
+                    if (b.block.GetHash() != b.hash) {
+                        error("%s: block hash doesn't match index at height %d", __func__, b.pindex->nHeight);
+                        return true;
+                    }
+                    b.fRead = true;
+                    b.vMaybeMine.resize(b.block.vtx.size());
+                    for (size_t i = 0; i < b.block.vtx.size(); i++)
+                        b.vMaybeMine[i] = MayInvolveMe(*b.block.vtx[i]);
+                    return true;
+                });
+            }
+            return batch;
+        };
+
+        // transactions the matching can not see, those spending from or conflicting with wallet transactions
+        auto isKnownToWallet = [this](const CTransaction& tx) {
+            if (mapWallet.count(tx.GetHash()))
+                return true;
+            for (const CTxIn& txin : tx.vin) {
+                if (mapWallet.count(txin.prevout.hash) || mapTxSpends.count(txin.prevout))
+                    return true;
+            }
+            return false;
+        };
+
+        std::unique_ptr<RescanBatch> batch;
+        if (pindex)
+            batch = prefetch(pindex);
+        while (batch)
         {
-            // A temporary fix for inability to Ctrl-C rescan when restoring a wallet (will be fixed in 0.15.)
-            if (ShutdownRequested())
-                return nullptr;
-            if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
-                ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
-            if (GetTime() >= nNow + 60) {
-                nNow = GetTime();
-                LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
+            // read the next blocks while these are applied
+            std::unique_ptr<RescanBatch> nextBatch;
+            if (CBlockIndex* pindexNext = chainActive.Next(batch->blocks.back().pindex))
+                nextBatch = prefetch(pindexNext);
+
+            {
+                DoNotDisturb dnd;
+                batch->tasks->Wait();
             }
 
-            CBlock block;
-            if (ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
-                for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    AddToWalletIfInvolvingMe(*block.vtx[posInBlock], pindex, posInBlock, fUpdate);
+            for (RescanBlock& b : batch->blocks) {
+                pindex = b.pindex;
+
+                // A temporary fix for inability to Ctrl-C rescan when restoring a wallet (will be fixed in 0.15.)
+                if (ShutdownRequested()) {
+                    LOCK(cs_rescanProgress);
+                    rescanProgress.fScanning = false;
+                    rescanProgress.nEndTime = GetTimeMillis();
+                    return nullptr;
                 }
-                if (!ret) {
-                    ret = pindex;
+                if (pindex->nHeight % 100 == 0 && dProgressTip - dProgressStart > 0.0)
+                    ShowProgress(_("Rescanning..."), std::max(1, std::min(99, (int)((GuessVerificationProgress(chainParams.TxData(), pindex) - dProgressStart) / (dProgressTip - dProgressStart) * 100))));
+                if (GetTime() >= nNow + 60) {
+                    nNow = GetTime();
+                    LogPrintf("Still rescanning. At block %d. Progress=%f\n", pindex->nHeight, GuessVerificationProgress(chainParams.TxData(), pindex));
                 }
-            } else {
-                ret = nullptr;
+
+                if (b.fRead) {
+                    bool fMatched = b.nKeyGeneration == nKeyGeneration;
+                    for (size_t posInBlock = 0; posInBlock < b.block.vtx.size(); ++posInBlock) {
+                        const CTransaction& tx = *b.block.vtx[posInBlock];
+                        if (fMatched && !b.vMaybeMine[posInBlock] && !isKnownToWallet(tx))
+                            continue;
+                        size_t nKeys = mapKeyMetadata.size();
+                        AddToWalletIfInvolvingMe(tx, pindex, posInBlock, fUpdate);
+                        if (mapKeyMetadata.size() != nKeys) {
+                            nKeyGeneration++;
+                            fMatched = false;
+                        }
+                    }
+                    if (!ret) {
+                        ret = pindex;
+                    }
+                } else {
+                    ret = nullptr;
+                }
+
+                LOCK(cs_rescanProgress);
+                rescanProgress.nHeight = pindex->nHeight;
+                rescanProgress.nBlocks++;
+                rescanProgress.nTransactions += b.block.vtx.size();
             }
-            pindex = chainActive.Next(pindex);
+
+            batch = std::move(nextBatch);
         }
         ShowProgress(_("Rescanning..."), 100); // hide progress dialog in GUI
+
+        LOCK(cs_rescanProgress);
+        rescanProgress.fScanning = false;
+        rescanProgress.nEndTime = GetTimeMillis();
     }
     return ret;
 }
 
+CWalletRescanProgress CWallet::GetRescanProgress() const
+{
+    LOCK(cs_rescanProgress);
+    return rescanProgress;
+}
+
 void CWallet::ReacceptWalletTransactions()
 {
     // If transactions aren't being broadcasted, don't let them into local mempool either
@@ -2650,7 +2798,7 @@ std::pair<CAmount, CAmount> CWallet::GetPrivateBalance(size_t &confirmed, size_t
     if(!zwallet)
         return balance;
 
-    auto lelantusCoins = zwallet->GetTracker().ListLelantusMints(true, false, false);
+    auto lelantusCoins = zwallet->GetTracker().ListSpendableLelantusMints(false);
     for (auto const &c : lelantusCoins) {
 
         if (c.isUsed || c.isArchived || !c.isSeedCorrect) {
@@ -2996,7 +3144,7 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
     LOCK2(cs_main, cs_wallet);
     CWalletDB walletdb(strWalletFile);
     std::list<CLelantusEntry> coins;
-    std::vector<CLelantusMintMeta> vecMints = zwallet->GetTracker().ListLelantusMints(true, true, false);
+    std::vector<CLelantusMintMeta> vecMints = zwallet->GetTracker().ListSpendableLelantusMints(true);
     for (const CLelantusMintMeta& mint : vecMints) {
         CLelantusEntry entry;
         GetMint(mint.hashSerial, entry, forEstimation);
@@ -3005,12 +3153,14 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
     }
 
     std::set<COutPoint> lockedCoins = setLockedCoins;
+    // sizes of the coin groups, coins of the same group share the anonymity set
+    std::map<int, size_t> groupSizes;
 
     // Filter out coins which are not confirmed, I.E. do not have at least 2 blocks
     // above them, after they were minted.
     // Also filter out used coins.
     // Finally filter out coins that have not been selected from CoinControl should that be used
-    coins.remove_if([lockedCoins, coinControl, includeUnsafe](const CLelantusEntry& coin) {
+    coins.remove_if([&lockedCoins, &groupSizes, coinControl, includeUnsafe](const CLelantusEntry& coin) {
         lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
         if (coin.IsUsed)
             return true;
@@ -3019,19 +3169,17 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
         std::tie(coinHeight, coinId) =  state->GetMintedCoinHeightAndId(lelantus::PublicCoin(coin.value));
 
         // Check group size
-        uint256 hashOut;
-        std::vector<lelantus::PublicCoin> coinOuts;
-        std::vector<unsigned char> setHash;
-        state->GetCoinSetForSpend(
-            &chainActive,
-            chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
-            coinId,
-            hashOut,
-            coinOuts,
-            setHash
-        );
+        auto groupIt = groupSizes.find(coinId);
+        if (groupIt == groupSizes.end()) {
+            auto coinSet = state->GetCoinSetSnapshotForSpend(
+                &chainActive,
+                chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
+                coinId
+            );
+            groupIt = groupSizes.emplace(coinId, coinSet->coins.size()).first;
+        }
 
-        if (!includeUnsafe && coinOuts.size() < 2) {
+        if (!includeUnsafe && groupIt->second < 2) {
             return true;
         }
 
@@ -3283,7 +3431,10 @@ bool CWallet::GetCoinsToJoinSplit(
     auto comparer = [](const CLelantusEntry& a, const CLelantusEntry& b) -> bool {
         return a.amount != b.amount ? a.amount > b.amount : a.nHeight < b.nHeight;
     };
-    coins.sort(comparer);
+    // ordered set, so every coin is picked in logarithmic time
+    std::multiset<CLelantusEntry, decltype(comparer)> sortedCoins(comparer);
+    for (const CLelantusEntry& coin : coins)
+        sortedCoins.insert(sortedCoins.end(), coin);
 
     CAmount spend_val(0);
 
@@ -3293,42 +3444,38 @@ bool CWallet::GetCoinsToJoinSplit(
     bool coinControlUsed = false;
     if(coinControl != NULL) {
         if(coinControl->HasSelected()) {
-            auto coinIt = coins.rbegin();
-            for (; coinIt != coins.rend(); coinIt++) {
-                spend_val += coinIt->amount;
+            for (const CLelantusEntry& coin : sortedCoins) {
+                spend_val += coin.amount;
             }
             coinControlUsed = true;
-            coinsToSpend.insert(coinsToSpend.begin(), coins.begin(), coins.end());
+            coinsToSpend.insert(coinsToSpend.begin(), sortedCoins.begin(), sortedCoins.end());
         }
     }
 
     if(!coinControlUsed) {
         while (spend_val < required) {
-            if(coins.empty())
+            if(sortedCoins.empty())
                 break;
 
-            CLelantusEntry choosen;
             CAmount need = required - spend_val;
 
-            auto itr = coins.begin();
-            if(need >= itr->amount) {
-                choosen = *itr;
-                coins.erase(itr);
-            } else {
-                for (auto coinIt = coins.rbegin(); coinIt != coins.rend(); coinIt++) {
-                    auto nextItr = coinIt;
-                    nextItr++;
-
-                    if (coinIt->amount >= need && (nextItr == coins.rend() || nextItr->amount != coinIt->amount)) {
-                        choosen = *coinIt;
-                        coins.erase(std::next(coinIt).base());
-                        break;
-                    }
-                }
+            auto itr = sortedCoins.begin();
+            if(need < itr->amount) {
+                // the oldest of the smallest coins covering what is needed, coins of an amount are ordered by age
+                CLelantusEntry needed;
+                needed.amount = need;
+                needed.nHeight = std::numeric_limits<int>::max();
+                itr = std::prev(sortedCoins.lower_bound(needed));
+
+                CLelantusEntry older;
+                older.amount = itr->amount;
+                older.nHeight = std::numeric_limits<int>::min();
+                itr = sortedCoins.lower_bound(older);
             }
 
-            spend_val += choosen.amount;
-            coinsToSpend.push_back(choosen);
+            spend_val += itr->amount;
+            coinsToSpend.push_back(*itr);
+            sortedCoins.erase(itr);
         }
     }
 
@@ -6529,6 +6676,7 @@ std::string CWallet::GetWalletHelpString(bool showDebug)
     strUsage += HelpMessageOpt("-mnemonicpassphrase=<text>", _("User defined mnemonic passphrase for HD wallet (BIP39). Only has effect during wallet creation/first start (default: empty string)"));
     strUsage += HelpMessageOpt("-hdseed=<hex>", _("User defined seed for HD wallet (should be in hex). Only has effect during wallet creation/first start (default: randomly generated)"));
     strUsage += HelpMessageOpt("-batching", _("In case of sync/reindex verifies sigma/lelantus proofs with batch verification, default: true"));
+    strUsage += HelpMessageOpt("-batchingwindow=<n>", strprintf(_("Number of collected proofs after which batch verification of the collected block range is started in background, 0 to verify only once synced (default: %u)"), DEFAULT_BATCHING_WINDOW));
     strUsage += HelpMessageOpt("-walletrbf", strprintf(_("Send transactions with full-RBF opt-in enabled (default: %u)"), DEFAULT_WALLET_RBF));
     strUsage += HelpMessageOpt("-upgradewallet", _("Upgrade wallet to latest format on startup"));
     strUsage += HelpMessageOpt("-wallet=<file>", _("Specify wallet file (within data directory)") + " " + strprintf(_("(default: %s)"), DEFAULT_WALLET_DAT));
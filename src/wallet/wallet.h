@@ -641,6 +641,19 @@ private:
 
 class LelantusJoinSplitBuilder;
 
+/** Progress of a running wallet rescan */
+struct CWalletRescanProgress
+{
+    bool fScanning{false};
+    int nStartHeight{0};
+    int nHeight{0};
+    int nTipHeight{0};
+    int64_t nStartTime{0};
+    int64_t nEndTime{0};
+    uint64_t nBlocks{0};
+    uint64_t nTransactions{0};
+};
+
 /**
  * A CWallet is an extension of a keystore, which also maintains a set of transactions and balances,
  * and provides the ability to create new transactions.
@@ -705,6 +718,16 @@ private:
 
     std::shared_ptr<bip47::CWallet> bip47wallet;
 
+    mutable CCriticalSection cs_rescanProgress;
+    CWalletRescanProgress rescanProgress;
+
+    /**
+     * Cheap check whether a transaction may involve the wallet, without taking cs_wallet. Looks for outputs paying to
+     * wallet keys and for outputs and inputs which need the wallet database to decide. Inputs spending wallet
+     * transactions are not detected.
+     */
+    bool MayInvolveMe(const CTransaction& tx) const;
+
     /**
      * Private version of AddWatchOnly method which does not accept a
      * timestamp, and which will reset the wallet's nTimeFirstKey value to 1 if
@@ -909,6 +932,7 @@ public:
     void SyncTransaction(const CTransaction& tx, const CBlockIndex *pindex, int posInBlock) override;
     bool AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex* pIndex, int posInBlock, bool fUpdate);
     CBlockIndex* ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate = false, bool fRecoverMnemonic = false);
+    CWalletRescanProgress GetRescanProgress() const;
     void ReacceptWalletTransactions();
     void ResendWalletTransactions(int64_t nBestBlockTime, CConnman* connman) override;
     std::vector<uint256> ResendWalletTransactionsBefore(int64_t nTime, CConnman* connman);